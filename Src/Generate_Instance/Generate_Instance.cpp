@@ -3,6 +3,7 @@
 #include <cstring>
 #include <fstream>
 #include <ctime>
+#include <vector>
 
 using namespace std;
 
@@ -16,6 +17,9 @@ void print_help() {
     cout << "\t-instances: The number of instances to be tested (default: 1000)" << endl;
     cout << "\t-mode: The mode of instance path (default: 0). 0 for general instances and 1 for special instances" << endl;
     cout << "\t-InsDir: Base directory for instance files (default: ./General(or Special)_Instances/[dim])" << endl;
+    cout << "\t-obstacle: The percentage of blocked vertices, which have no edge (default: 0)" << endl;
+    cout << "\t-removal: The percentage of removed edges between the other vertices (default: 0)" << endl;
+    cout << "\t-dimz: The number of planes of a 3D mesh of dim x dim x dimz vertices (default: 1, a 2D mesh)" << endl;
     cout << "\t-h: Display this help and exit" << endl;
     exit(EXIT_FAILURE);
 }
@@ -29,8 +33,12 @@ void print_help() {
  * @param n_instances Reference to the number of instances variable.
  * @param mode Reference to the mode variable.
  * @param insDir Reference to the instance directory variable.
+ * @param obstacle Reference to the percentage of blocked vertices.
+ * @param removal Reference to the percentage of removed edges.
+ * @param dimz Reference to the number of planes variable.
  */
-void parse_arguments(int argc, char* argv[], int& dim, int& n_instances, int& mode, string& insDir) {
+void parse_arguments(int argc, char* argv[], int& dim, int& n_instances, int& mode, string& insDir,
+                     int& obstacle, int& removal, int& dimz) {
     // Parse command-line arguments
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "-h") == 0) { // Check for help flag first
@@ -65,6 +73,27 @@ void parse_arguments(int argc, char* argv[], int& dim, int& n_instances, int& mo
                 cerr << "Error: -InsDir requires a value." << endl;
                 print_help();
             }
+        } else if (strcmp(argv[i], "-obstacle") == 0) {
+            if (i + 1 < argc) {
+                obstacle = atoi(argv[++i]);
+            } else {
+                cerr << "Error: -obstacle requires a value." << endl;
+                print_help();
+            }
+        } else if (strcmp(argv[i], "-removal") == 0) {
+            if (i + 1 < argc) {
+                removal = atoi(argv[++i]);
+            } else {
+                cerr << "Error: -removal requires a value." << endl;
+                print_help();
+            }
+        } else if (strcmp(argv[i], "-dimz") == 0) {
+            if (i + 1 < argc) {
+                dimz = atoi(argv[++i]);
+            } else {
+                cerr << "Error: -dimz requires a value." << endl;
+                print_help();
+            }
         } else {
             cerr << "Error: Unknown argument '" << argv[i] << "'." << endl;
             print_help();
@@ -73,8 +102,57 @@ void parse_arguments(int argc, char* argv[], int& dim, int& n_instances, int& mo
 
     // Update instance directory based on mode if not set
     if (insDir.length() == 0) {
-        if (mode == 0) insDir = "./General_Instances/" + to_string(dim);
-        else insDir = "./Special_Instances/" + to_string(dim);
+        string dim_name = dimz > 1 ? to_string(dim) + "x" + to_string(dimz) : to_string(dim);
+        if (mode == 0) insDir = "./General_Instances/" + dim_name;
+        else insDir = "./Special_Instances/" + dim_name;
+    }
+}
+
+/**
+ * @brief Writes one instance of a 3D mesh of dim x dim x dimz vertices. The weights are kept
+ * in one plane per axis instead of the adjacency matrix, which would not fit in memory.
+ *
+ * @param ofile The output file.
+ * @param dim The number of rows and columns of each plane.
+ * @param dimz The number of planes.
+ * @param mode The mode of the instance (0 for general, otherwise for uniform edge weight along the rows).
+ * @param obstacle The percentage of blocked vertices.
+ * @param removal The percentage of removed edges.
+ */
+void generate_mesh(ofstream& ofile, int dim, int dimz, int mode, int obstacle, int removal) {
+    int plane_size = dim * dim; // Number of vertices of a plane
+    int n_vertices = plane_size * dimz; // Total number of vertices in the mesh
+    int herizon_edge_len = rand() % 10000 + 1; // Generate a random edge length for special mode
+
+    // A weight of 0 marks a missing edge, which is omitted from the file
+    vector<int> x_w(n_vertices, 0), y_w(n_vertices, 0), z_w(n_vertices, 0); // Edges (v, v + 1), (v, v + dim), (v, v + plane_size)
+    vector<bool> is_blocked(n_vertices, false); // Blocked vertices, without any edge
+    for (int i = 0; i < n_vertices; i++)
+        is_blocked[i] = obstacle > 0 && rand() % 100 < obstacle;
+    for (int i = 0; i < n_vertices; i++) {
+        if (i % dim + 1 != dim && !is_blocked[i] && !is_blocked[i + 1] && !(removal > 0 && rand() % 100 < removal))
+            x_w[i] = mode ? herizon_edge_len : rand() % 10000 + 1;
+        if (i % plane_size + dim < plane_size && !is_blocked[i] && !is_blocked[i + dim] && !(removal > 0 && rand() % 100 < removal))
+            y_w[i] = rand() % 10000 + 1;
+        if (i + plane_size < n_vertices && !is_blocked[i] && !is_blocked[i + plane_size] && !(removal > 0 && rand() % 100 < removal))
+            z_w[i] = rand() % 10000 + 1;
+    }
+
+    ofile << dim << " " << dim << " " << dimz << endl << endl; // Write the dimensions to the file
+    for (int i = 0; i < n_vertices; i++) {
+        ofile << i << " "; // Output the current vertex index
+
+        // Neighbors in the previous and next planes
+        if (i >= plane_size && z_w[i - plane_size]) ofile << i - plane_size << " " << z_w[i - plane_size] << " ";
+        if (z_w[i]) ofile << i + plane_size << " " << z_w[i] << " ";
+        // Upper and below neighbors
+        if (i % plane_size >= dim && y_w[i - dim]) ofile << i - dim << " " << y_w[i - dim] << " ";
+        if (y_w[i]) ofile << i + dim << " " << y_w[i] << " ";
+        // Left and right neighbors
+        if (i % dim && x_w[i - 1]) ofile << i - 1 << " " << x_w[i - 1] << " ";
+        if (x_w[i]) ofile << i + 1 << " " << x_w[i] << " ";
+
+        ofile << endl;
     }
 }
 
@@ -87,15 +165,29 @@ int main(int argc, char* argv[]) {
     int n_instances = 1000;  // Number of instances
     int mode = 0;  // Instance mode (0 for general, otherwise for uniform edge weight)
     string insDir = "";  // Instance directory
-    parse_arguments(argc, argv, dim, n_instances, mode, insDir);
+    int obstacle = 0;  // Percentage of blocked vertices
+    int removal = 0;  // Percentage of removed edges
+    int dimz = 1;  // Number of planes (1 for a 2D mesh)
+    parse_arguments(argc, argv, dim, n_instances, mode, insDir, obstacle, removal, dimz);
 
     srand((unsigned)time(0)); // Seed the random number generator with current time
 
+    if (dimz > 1) { // Generate 3D meshes
+        for (int ite = 0; ite < n_instances; ++ite) {
+            string ofile_name = insDir + "/instance" + to_string(ite + 1) + ".txt"; // Create the output file name
+            ofstream ofile(ofile_name.c_str()); // Open the output file for writing
+            generate_mesh(ofile, dim, dimz, mode, obstacle, removal);
+            ofile.close(); // Close the output file
+        }
+        return 0;
+    }
+
     // Initialize basic variables
     int n_vertices = dim * dim; // Total number of vertices in the graph
     int** arcs = new int* [n_vertices]; // Allocate memory for the adjacency matrix
     for (int i = 0; i < n_vertices; i++)
         arcs[i] = new int[n_vertices];
+    vector<bool> is_blocked(n_vertices, false); // Blocked vertices, without any edge
 
     // Begin generating instances
     for (int ite = 0; ite < n_instances; ++ite) {
@@ -105,33 +197,41 @@ int main(int argc, char* argv[]) {
         int herizon_edge_len = rand() % 10000 + 1; // Generate a random edge length for special mode
         for (int i = 0; i < n_vertices; i++)     // Initialize the arcs (adjacency matrix) to zero
             memset(arcs[i], 0, sizeof(arcs[i]));
+        for (int i = 0; i < n_vertices; i++)     // Choose the blocked vertices
+            is_blocked[i] = obstacle > 0 && rand() % 100 < obstacle;
 
         ofile << dim << endl << endl; // Write the dimension to the file
         for (int i = 0; i < n_vertices; i++) {
             ofile << i << " "; // Output the current vertex index
             
+            // A weight of 0 marks a missing edge, which is omitted from the file
             // Upper neighbor
-            if (i >= dim) { 
+            if (i >= dim && arcs[i][i - dim]) { 
                 ofile << i - dim << " " << arcs[i][i - dim] << " ";
             }
             // Below neighbor
             if (i + dim < n_vertices) {
-                arcs[i][i + dim] = arcs[i + dim][i] = rand() % 10000 + 1; // Assign random weight
-                ofile << i + dim << " " << arcs[i][i + dim] << " ";
+                if (is_blocked[i] || is_blocked[i + dim] || (removal > 0 && rand() % 100 < removal))
+                    arcs[i][i + dim] = arcs[i + dim][i] = 0; // Remove the edge
+                else
+                    arcs[i][i + dim] = arcs[i + dim][i] = rand() % 10000 + 1; // Assign random weight
+                if (arcs[i][i + dim]) ofile << i + dim << " " << arcs[i][i + dim] << " ";
             }
             // Left neighbor
-            if (i % dim) {
+            if (i % dim && arcs[i][i - 1]) {
                 ofile << i - 1 << " " << arcs[i][i - 1] << " ";
             }
             // Right neighbor
             if (i % dim + 1 != dim) {
                 // Assign edge weights based on mode
-                if (!mode) 
+                if (is_blocked[i] || is_blocked[i + 1] || (removal > 0 && rand() % 100 < removal))
+                    arcs[i][i + 1] = arcs[i + 1][i] = 0; // Remove the edge
+                else if (!mode) 
                     arcs[i][i + 1] = arcs[i + 1][i] = rand() % 10000 + 1; // Random weight for general mode
                 else 
                     arcs[i][i + 1] = arcs[i + 1][i] = herizon_edge_len; // Uniform weight for special mode
                 
-                ofile << i + 1 << " " << arcs[i][i + 1] << " ";
+                if (arcs[i][i + 1]) ofile << i + 1 << " " << arcs[i][i + 1] << " ";
             }
 
             ofile << endl;
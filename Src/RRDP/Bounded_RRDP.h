@@ -0,0 +1,241 @@
+#ifndef _Bounded_RRDP_h
+#define _Bounded_RRDP_h
+
+#include <climits>
+#include <algorithm>
+
+#include "RRDP.h"
+
+// A vertex within the radius of the bounded RRDP, with its shortest distance
+struct t_iso_vertex {
+    int vtx; // Vertex index
+    int dis; // Shortest distance from the source vertex
+
+    t_iso_vertex(int v, int d) : vtx(v), dis(d) {}
+
+    bool operator<(const t_iso_vertex& other) const {
+        return vtx < other.vtx;
+    }
+};
+
+// State of the bounded RRDP, kept by the caller between the queries on the same graph.
+// Only the vertices within the radius (and some of their neighbors) are present,
+// and every non-present neighbor x of a present vertex u satisfies D[u] + w(u, x) > R,
+// hence no vertex within the radius can be reached through a non-present vertex.
+struct t_bounded_state {
+    int R;                  // Radius of the query
+    int* D;                 // Shortest distances, only valid for present vertices
+    int* P;                 // Predecessors, only valid for present vertices
+    int top, bottom;        // Rows which have been swept (the band)
+    vector<char> is_present;// Track if vertices are present, all false between two queries
+    vector<int> row_lo;     // First present column of each row of the band
+    vector<int> row_hi;     // Last present column of each row of the band
+    vector<int> visited;    // Present vertices, used to output the result and reset is_present
+    queue<int> Q;           // Queue for processing vertices
+};
+
+/**
+ * @brief Marks a vertex as present with its tentative shortest distance.
+ *
+ * @param S The state of the bounded RRDP.
+ * @param vtx The vertex.
+ * @param row The row of the vertex.
+ * @param col The column of the vertex.
+ * @param dis The tentative shortest distance of the vertex.
+ * @param pre The predecessor of the vertex.
+ */
+inline void add_present(t_bounded_state &S, int vtx, int row, int col, int dis, int pre) {
+    S.is_present[vtx] = true;
+    S.D[vtx] = dis;
+    S.P[vtx] = pre;
+    S.visited.emplace_back(vtx);
+    S.row_lo[row] = min(S.row_lo[row], col);
+    S.row_hi[row] = max(S.row_hi[row], col);
+}
+
+/**
+ * @brief Traces the changes caused by the vertices in the queue inside the band.
+ * Unlike trace_change, a non-present neighbor becomes present if its new cost is within the radius.
+ *
+ * @param S The state of the bounded RRDP.
+ */
+void trace_change_bounded(t_bounded_state &S) {
+    int cur_vtx, next_vertex, next_row, tmp_cost, n_next;
+    int next_vertices[6], lengths[6]; // Neighbors of the current vertex
+    t_planes G = get_planes(); // The graph bound to the global variables
+    int* D = S.D;
+    char* is_present = S.is_present.data();
+
+    while (!S.Q.empty()) { // Process the queue until it's empty
+        cur_vtx = S.Q.front(); S.Q.pop(); // Pop a vertex from the queue
+
+        // Iterate through the neighbors of the current vertex
+        n_next = get_neighbors(G, cur_vtx, next_vertices, lengths);
+        for (int i = 0; i < n_next; i++) {
+            next_vertex = next_vertices[i];
+            next_row = next_vertex / g_dim;
+            if (next_row < S.top || next_row > S.bottom) continue; // Skip rows out of the band
+
+            // Calculate the new cost to reach the vertex
+            tmp_cost = D[cur_vtx] + lengths[i];
+            if (is_present[next_vertex]) {
+                if (tmp_cost < D[next_vertex]) { // Update if the new cost is lower
+                    D[next_vertex] = tmp_cost;
+                    S.P[next_vertex] = cur_vtx;
+                    S.Q.push(next_vertex);
+                }
+            } else if (tmp_cost <= S.R) { // The vertex enters the radius
+                add_present(S, next_vertex, next_row, next_vertex - next_row * g_dim, tmp_cost, cur_vtx);
+                S.Q.push(next_vertex);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Sweeps a row adjacent to the band, only over the columns that can be within the radius.
+ *
+ * @param S The state of the bounded RRDP.
+ * @param row The row to be swept.
+ * @param pre_row The boundary row of the band next to it.
+ * @return false if no vertex of the row is within the radius, true otherwise.
+ */
+bool sweep_row_bounded(t_bounded_state &S, int row, int pre_row) {
+    int* D = S.D;
+    int* P = S.P;
+    char* is_present = S.is_present.data();
+    int R = S.R;
+    int pre_begin_vtx = pre_row * g_dim, cur_begin_vtx = row * g_dim;
+    int col, vtx, tmp_vtx, tmp_cost1, tmp_cost2;
+
+    // The seeds are the present vertices of the previous row that reach this row within the radius
+    int lo = g_dim, hi = -1;
+    for (col = S.row_lo[pre_row]; col <= S.row_hi[pre_row]; ++col) {
+        tmp_vtx = pre_begin_vtx + col;
+        if (is_present[tmp_vtx] && D[tmp_vtx] + edge_length(tmp_vtx, tmp_vtx + cur_begin_vtx - pre_begin_vtx) <= R) {
+            lo = min(lo, col);
+            hi = col;
+        }
+    }
+    if (hi < 0) return false; // Every column of this row is out of the radius
+
+    S.row_lo[row] = g_dim;
+    S.row_hi[row] = -1;
+    if (row < S.top) S.top = row;
+    if (row > S.bottom) S.bottom = row;
+
+    // Process from left to right between the seeds, then extend to the right within the radius
+    for (col = lo; col < g_dim; ++col) {
+        vtx = cur_begin_vtx + col;
+        tmp_vtx = pre_begin_vtx + col;
+
+        tmp_cost1 = col > lo ? D[vtx - 1] + g_row_w[vtx - 1] : INT_MAX; // New cost from the left neighbor
+        tmp_cost2 = is_present[tmp_vtx] ? D[tmp_vtx] + edge_length(vtx, tmp_vtx) : INT_MAX; // New cost from the previous row
+        if (col > hi && min(tmp_cost1, tmp_cost2) > R) break; // Out of the radius from here on
+
+        // Between the seeds, a vertex behind missing edges is bounded by INF
+        if (tmp_cost1 < tmp_cost2) add_present(S, vtx, row, col, min(tmp_cost1, INF), vtx - 1);
+        else add_present(S, vtx, row, col, min(tmp_cost2, INF), tmp_vtx);
+    }
+
+    // Process from right to left, then extend to the left within the radius
+    for (col = S.row_hi[row] - 1; col >= 0; --col) {
+        vtx = cur_begin_vtx + col;
+        tmp_cost1 = D[vtx + 1] + g_row_w[vtx]; // New cost from the right neighbor
+        if (col >= lo) {
+            if (tmp_cost1 < D[vtx]) {
+                D[vtx] = tmp_cost1;  P[vtx] = vtx + 1;
+            }
+            continue;
+        }
+
+        tmp_vtx = pre_begin_vtx + col;
+        tmp_cost2 = is_present[tmp_vtx] ? D[tmp_vtx] + edge_length(vtx, tmp_vtx) : INT_MAX; // New cost from the previous row
+        if (min(tmp_cost1, tmp_cost2) > R) break; // Out of the radius from here on
+
+        if (tmp_cost1 < tmp_cost2) add_present(S, vtx, row, col, tmp_cost1, vtx + 1);
+        else add_present(S, vtx, row, col, tmp_cost2, tmp_vtx);
+    }
+
+    // For the vertices in the previous row, calculate the new cost from this row
+    for (col = S.row_lo[row]; col <= S.row_hi[row]; ++col) {
+        vtx = cur_begin_vtx + col;
+        tmp_vtx = pre_begin_vtx + col;
+        tmp_cost2 = D[vtx] + edge_length(vtx, tmp_vtx);
+        if (is_present[tmp_vtx]) {
+            if (tmp_cost2 < D[tmp_vtx]) { // Update if the new cost is lower
+                D[tmp_vtx] = tmp_cost2; P[tmp_vtx] = vtx;
+                S.Q.push(tmp_vtx);
+            }
+        } else if (tmp_cost2 <= R) { // The vertex enters the radius
+            add_present(S, tmp_vtx, pre_row, col, tmp_cost2, vtx);
+            S.Q.push(tmp_vtx);
+        }
+    }
+    trace_change_bounded(S); // Update distances using trace_change_bounded
+    return true;
+}
+
+/**
+ * @brief Implements the bounded RRDP algorithm, which finds the vertices within a radius
+ * of the source vertex (isochrone) with their shortest distances.
+ * A shortest path to a row beyond the band crosses the boundary row of the band, so the
+ * sweep stops in one direction as soon as no vertex of the boundary row reaches the next
+ * row within the radius, and only the columns reachable within the radius are swept.
+ * The cost grows with the area of the isochrone instead of the size of the graph.
+ *
+ * @param R The radius.
+ * @param D An array holding the shortest distances, only written for the vertices around the isochrone.
+ * @param P An array holding the predecessors, only written for the vertices around the isochrone.
+ * @param iso The vertices within the radius with their shortest distances, sorted by vertex.
+ * @param S The workspace of the bounded RRDP. It is kept between calls, and is_present is
+ * only reset where it was set, so the cost of a call does not depend on the size of the graph.
+ */
+void rrdp_bounded(int R, int* D, int* P, vector<t_iso_vertex> &iso, t_bounded_state &S) {
+    S.R = R;
+    S.D = D;
+    S.P = P;
+    S.top = S.bottom = g_src_vtx_row;
+    S.is_present.resize(g_n_vtx, false);
+    S.row_lo.resize(g_dim);
+    S.row_hi.resize(g_dim);
+    S.visited.clear();
+    iso.clear();
+
+    int col, vtx, tmp_cost1;
+
+    // Process the row containing the source vertex
+    S.row_lo[g_src_vtx_row] = S.row_hi[g_src_vtx_row] = g_src_vtx_col;
+    add_present(S, g_src_vtx, g_src_vtx_row, g_src_vtx_col, 0, g_src_vtx);
+    // Process from right to left
+    for (col = g_src_vtx_col - 1, vtx = g_src_vtx - 1; col >= 0; --col, --vtx) {
+        tmp_cost1 = D[vtx + 1] + g_row_w[vtx];
+        if (tmp_cost1 > R) break; // Out of the radius from here on
+        add_present(S, vtx, g_src_vtx_row, col, tmp_cost1, vtx + 1);
+    }
+    // Process from left to right
+    for (col = g_src_vtx_col + 1, vtx = g_src_vtx + 1; col < g_dim; ++col, ++vtx) {
+        tmp_cost1 = D[vtx - 1] + g_row_w[vtx - 1];
+        if (tmp_cost1 > R) break; // Out of the radius from here on
+        add_present(S, vtx, g_src_vtx_row, col, tmp_cost1, vtx - 1);
+    }
+
+    // Grow the band below and above the source vertex until both boundary rows are out of the radius.
+    // Sweeping one side may decrease the distances in the boundary row of the other side,
+    // so both sides are checked again until none of them grows.
+    bool is_growing = true;
+    while (is_growing) {
+        is_growing = false;
+        while (S.bottom + 1 < g_dim && sweep_row_bounded(S, S.bottom + 1, S.bottom)) is_growing = true;
+        while (S.top > 0 && sweep_row_bounded(S, S.top - 1, S.top)) is_growing = true;
+    }
+
+    // Output the vertices within the radius and reset the workspace
+    for (int present_vtx : S.visited) {
+        if (D[present_vtx] <= R) iso.emplace_back(t_iso_vertex(present_vtx, D[present_vtx]));
+        S.is_present[present_vtx] = false;
+    }
+    sort(iso.begin(), iso.end());
+}
+
+#endif // !_Bounded_RRDP_h
@@ -0,0 +1,433 @@
+#ifndef _Distance_Oracle_h
+#define _Distance_Oracle_h
+
+#include <cstdio>
+#include <fstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "RRDP.h"
+
+// Magic number written at the beginning of every oracle file
+#define ORACLE_MAGIC "RRDPORC2"
+
+// Header of an oracle file, followed by the separator rows, the weight planes,
+// the distances of the vertices and the distances between the separator rows
+struct t_oracle_header {
+    char magic[8];  // Must be equal to ORACLE_MAGIC
+    int dim;        // Dimension of the graph
+    int stride;     // Number of rows between two separator rows
+    int n_sep;      // Number of separator rows
+    int reserved;   // Keeps the arrays behind the header 8-byte aligned
+};
+
+// Distance oracle answering point-to-point queries on a static graph
+struct t_oracle {
+    int dim;        // Dimension of the graph
+    int n_vtx;      // Total number of vertices in the graph
+    int stride;     // Number of rows between two separator rows
+    int n_sep;      // Number of separator rows
+
+    int* sep_rows;  // Row index of each separator row
+    int* row_w;     // row_w[v] is the length of the horizontal edge (v, v + 1)
+    int* col_w;     // col_w[v] is the length of the vertical edge (v, v + dim)
+    // dis[(v * 2 + side) * dim + j] is the distance between vertex v and the j-th vertex
+    // of the last separator row not below v (side 0) or of the first one not above v (side 1),
+    // INF if there is no such separator row. A vertex only keeps the separator rows around its stripe.
+    int* dis;
+    // sep_dis[sep_pair(k, k') * dim * dim + j * dim + l] is the distance between the j-th vertex
+    // of the k-th separator row and the l-th vertex of the k'-th one, for k < k'
+    int* sep_dis;
+
+    void* map_addr; // Address of the mapped oracle file, NULL if the arrays are on the heap
+    size_t map_len; // Length of the mapped oracle file
+};
+
+/**
+ * @brief Gets the number of separator rows of an oracle, one every "stride" rows from the row stride / 2.
+ *
+ * @param dim The dimension of the graph.
+ * @param stride Number of rows between two separator rows.
+ * @return The number of separator rows.
+ */
+inline int separator_count(int dim, int stride) {
+    return max(0, (dim - stride / 2 + stride - 1) / stride);
+}
+
+/**
+ * @brief Gets the index of the table of distances between two separator rows in sep_dis.
+ *
+ * @param n_sep The number of separator rows.
+ * @param k The index of the first separator row.
+ * @param k2 The index of the second separator row, greater than k.
+ * @return The index of the table.
+ */
+inline size_t sep_pair(int n_sep, int k, int k2) {
+    return (size_t)k * (2 * n_sep - k - 1) / 2 + (k2 - k - 1);
+}
+
+/**
+ * @brief Gets the number of ints stored by an oracle, behind its header.
+ *
+ * @param dim The dimension of the graph.
+ * @param n_sep The number of separator rows.
+ * @return The number of ints of the separator rows, weight planes and distances.
+ */
+inline size_t oracle_size(int dim, int n_sep) {
+    size_t n_vtx = (size_t)dim * dim;
+    size_t n_pairs = (size_t)n_sep * (n_sep - 1) / 2; // Number of tables between separator rows
+    return n_sep + 2 * n_vtx + 2 * n_vtx * dim + n_pairs * dim * dim;
+}
+
+/**
+ * @brief Gets the last separator row not below a row.
+ *
+ * @param O The distance oracle.
+ * @param row The row.
+ * @return The index of the separator row, -1 if there is none.
+ */
+inline int up_separator(const t_oracle &O, int row) {
+    int offset = O.stride / 2;
+    return row < offset ? -1 : min((row - offset) / O.stride, O.n_sep - 1);
+}
+
+/**
+ * @brief Gets the first separator row not above a row.
+ *
+ * @param O The distance oracle.
+ * @param row The row.
+ * @return The index of the separator row, n_sep if there is none.
+ */
+inline int down_separator(const t_oracle &O, int row) {
+    int offset = O.stride / 2;
+    return row <= offset ? 0 : min((row - offset + O.stride - 1) / O.stride, O.n_sep);
+}
+
+/**
+ * @brief Builds the distance oracle of the current graph.
+ * Every "stride" rows, one row is chosen as separator and RRDP is run from
+ * each of its vertices. Any path between two vertices on different sides of
+ * a separator row passes through it, so a query reduces to a minimum over
+ * the vertices of the separator rows around the two vertices.
+ * Each vertex keeps its distances to the separator rows around its stripe only,
+ * and the distances between the separator rows are kept once per pair of rows.
+ *
+ * @param stride Number of rows between two separator rows. A smaller stride uses
+ * more memory (2 * g_n_vtx * g_dim distances for the vertices, and g_dim^2 for each
+ * pair of separator rows, i.e. about g_n_vtx^2 / (2 * stride^2)) but answers faster.
+ * @param O The oracle to be built.
+ */
+void build_oracle(int stride, t_oracle &O) {
+    O.dim = g_dim;
+    O.n_vtx = g_n_vtx;
+    O.stride = stride;
+    O.n_sep = separator_count(g_dim, stride);
+    O.map_addr = NULL;
+    O.map_len = 0;
+
+    O.sep_rows = new int[O.n_sep];
+    for (int k = 0; k < O.n_sep; k++)
+        O.sep_rows[k] = stride / 2 + k * stride;
+
+    // Copy the weight planes, so that the oracle does not need the graph any more
+    O.row_w = new int[g_n_vtx];
+    O.col_w = new int[g_n_vtx];
+    memcpy(O.row_w, g_row_w, g_n_vtx * sizeof(int));
+    memcpy(O.col_w, g_col_w, g_n_vtx * sizeof(int));
+
+    // Save the source vertex, since RRDP reads it from the global variables
+    int src_vtx = g_src_vtx, src_vtx_row = g_src_vtx_row, src_vtx_col = g_src_vtx_col;
+    int* D = new int[g_n_vtx];
+    int* P = new int[g_n_vtx];
+    fill(D, D + g_n_vtx, INF); // RRDP never writes the blocked vertices
+
+    // The vertices before the first separator row and after the last one miss a side
+    O.dis = new int[(size_t)2 * g_n_vtx * g_dim];
+    fill(O.dis, O.dis + (size_t)2 * g_n_vtx * g_dim, INF);
+    O.sep_dis = new int[(size_t)O.n_sep * (O.n_sep - 1) / 2 * g_dim * g_dim];
+    for (int k = 0; k < O.n_sep; k++) {
+        // The vertices having the k-th separator row on side 1 lie in the rows [down_begin, sep_rows[k]],
+        // those having it on side 0 in the rows [sep_rows[k], up_end)
+        int down_begin = k > 0 ? O.sep_rows[k - 1] + 1 : 0;
+        int up_end = k + 1 < O.n_sep ? O.sep_rows[k + 1] : g_dim;
+
+        for (int j = 0; j < g_dim; j++) {
+            g_src_vtx_row = O.sep_rows[k];
+            g_src_vtx_col = j;
+            g_src_vtx = g_src_vtx_row * g_dim + j;
+            rrdp(D, P); // Distances from the j-th vertex of the separator row
+
+            for (int v = down_begin * g_dim; v < (O.sep_rows[k] + 1) * g_dim; v++)
+                O.dis[((size_t)v * 2 + 1) * g_dim + j] = D[v];
+            for (int v = O.sep_rows[k] * g_dim; v < up_end * g_dim; v++)
+                O.dis[((size_t)v * 2) * g_dim + j] = D[v];
+            for (int k2 = k + 1; k2 < O.n_sep; k2++) {
+                int* dis_k2 = O.sep_dis + (sep_pair(O.n_sep, k, k2) * g_dim + j) * g_dim;
+                memcpy(dis_k2, D + O.sep_rows[k2] * g_dim, g_dim * sizeof(int));
+            }
+            D[g_src_vtx] = INF; // A blocked source vertex is not swept by the next run
+        }
+    }
+
+    g_src_vtx = src_vtx, g_src_vtx_row = src_vtx_row, g_src_vtx_col = src_vtx_col;
+    delete[] D;
+    delete[] P;
+}
+
+/**
+ * @brief Saves the distance oracle to a binary file, which can be mapped by load_oracle.
+ * The oracle is written to a temporary file renamed over the oracle file at the end,
+ * so that an interrupted save never leaves a truncated oracle file behind.
+ *
+ * @param file_path The path to the oracle file.
+ * @param O The oracle to be saved.
+ */
+void save_oracle(string file_path, const t_oracle &O) {
+    string tmp_path = file_path + ".tmp";
+    ofstream ofile(tmp_path.c_str(), ios::binary); // Open the temporary file for writing
+    if (ofile.fail()) { // Check if the file was opened successfully
+        cout << __FUNCTION__ << endl
+             << "Fail to open the file "
+             << tmp_path << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    t_oracle_header header;
+    memcpy(header.magic, ORACLE_MAGIC, sizeof(header.magic));
+    header.dim = O.dim;
+    header.stride = O.stride;
+    header.n_sep = O.n_sep;
+    header.reserved = 0;
+
+    ofile.write((const char*)&header, sizeof(header));
+    ofile.write((const char*)O.sep_rows, (size_t)O.n_sep * sizeof(int));
+    ofile.write((const char*)O.row_w, (size_t)O.n_vtx * sizeof(int));
+    ofile.write((const char*)O.col_w, (size_t)O.n_vtx * sizeof(int));
+    ofile.write((const char*)O.dis, (size_t)2 * O.n_vtx * O.dim * sizeof(int));
+    ofile.write((const char*)O.sep_dis, (size_t)O.n_sep * (O.n_sep - 1) / 2 * O.dim * O.dim * sizeof(int));
+    ofile.close(); // Close the temporary file
+    if (ofile.fail() || rename(tmp_path.c_str(), file_path.c_str()) != 0) {
+        cout << __FUNCTION__ << endl
+             << "Fail to write the file "
+             << file_path << endl;
+        remove(tmp_path.c_str());
+        exit(EXIT_FAILURE);
+    }
+
+    cout << "Save the distance oracle: " << file_path << endl;
+}
+
+/**
+ * @brief Maps an oracle file saved by save_oracle into memory.
+ *
+ * @param file_path The path to the oracle file.
+ * @param O The oracle to be loaded. Its arrays point into the mapped file.
+ * @return true if the oracle was loaded, false if the file cannot be opened or is not
+ * a valid oracle file, so that the oracle is built again.
+ */
+bool load_oracle(string file_path, t_oracle &O) {
+    int fd = open(file_path.c_str(), O_RDONLY);
+    if (fd < 0) return false; // The oracle has not been built yet
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(t_oracle_header)) {
+        close(fd);
+        cout << "Invalid oracle file " << file_path << ", rebuild it" << endl;
+        return false;
+    }
+    void* addr = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // The mapping stays valid after closing the file
+    if (addr == MAP_FAILED) {
+        cout << "Fail to map the oracle file " << file_path << ", rebuild it" << endl;
+        return false;
+    }
+
+    // Check the header and the size of the file
+    const t_oracle_header* header = (const t_oracle_header*)addr;
+    bool is_valid = memcmp(header->magic, ORACLE_MAGIC, sizeof(header->magic)) == 0;
+    size_t n_vtx = is_valid ? (size_t)header->dim * header->dim : 0;
+    if (is_valid) {
+        is_valid = header->dim > 0 && header->stride > 0
+                 && header->n_sep == separator_count(header->dim, header->stride) && (size_t)st.st_size
+                 == sizeof(t_oracle_header) + oracle_size(header->dim, header->n_sep) * sizeof(int);
+    }
+    if (!is_valid) {
+        cout << "Invalid oracle file " << file_path << ", rebuild it" << endl;
+        munmap(addr, st.st_size);
+        return false;
+    }
+
+    O.dim = header->dim;
+    O.n_vtx = (int)n_vtx;
+    O.stride = header->stride;
+    O.n_sep = header->n_sep;
+    O.sep_rows = (int*)(header + 1);
+    O.row_w = O.sep_rows + O.n_sep;
+    O.col_w = O.row_w + n_vtx;
+    O.dis = O.col_w + n_vtx;
+    O.sep_dis = O.dis + 2 * n_vtx * O.dim;
+    O.map_addr = addr;
+    O.map_len = st.st_size;
+    return true;
+}
+
+/**
+ * @brief Checks that an oracle belongs to the current graph and stride, by comparing
+ * its weight planes with those of the graph. Oracle files saved for another
+ * instance of the same dimension are therefore detected.
+ *
+ * @param O The distance oracle.
+ * @param stride The stride wanted for the oracle.
+ * @return true if the oracle was built on the current graph with this stride.
+ */
+bool oracle_matches_graph(const t_oracle &O, int stride) {
+    return O.dim == g_dim && O.stride == stride
+        && memcmp(O.row_w, g_row_w, g_n_vtx * sizeof(int)) == 0
+        && memcmp(O.col_w, g_col_w, g_n_vtx * sizeof(int)) == 0;
+}
+
+/**
+ * @brief Deallocates the memory of the distance oracle.
+ *
+ * @param O The oracle to be destroyed.
+ */
+void destroy_oracle(t_oracle &O) {
+    if (O.map_addr) {
+        munmap(O.map_addr, O.map_len);
+    } else {
+        delete[] O.sep_rows;
+        delete[] O.row_w;
+        delete[] O.col_w;
+        delete[] O.dis;
+        delete[] O.sep_dis;
+    }
+}
+
+/**
+ * @brief Calculates the distance between two vertices through one separator row.
+ *
+ * @param O The distance oracle.
+ * @param s The first vertex.
+ * @param s_side The side of the separator row for s, as in dis.
+ * @param t The second vertex.
+ * @param t_side The side of the separator row for t, the same separator row as for s.
+ * @return The length of the shortest path between s and t passing through the separator row.
+ */
+int oracle_via_separator(const t_oracle &O, int s, int s_side, int t, int t_side) {
+    const int* dis_s = O.dis + ((size_t)s * 2 + s_side) * O.dim;
+    const int* dis_t = O.dis + ((size_t)t * 2 + t_side) * O.dim;
+
+    int best = dis_s[0] + dis_t[0];
+    for (int j = 1; j < O.dim; j++)
+        best = min(best, dis_s[j] + dis_t[j]);
+    return min(best, INF); // Two INF may be added up
+}
+
+/**
+ * @brief Calculates the distance between two vertices through two separator rows,
+ * the k-th one being the first separator row not above s, and the k2-th one the last
+ * separator row not below t. Every path between them passes through both rows.
+ *
+ * @param O The distance oracle.
+ * @param k The index of the first separator row.
+ * @param k2 The index of the second separator row, greater than k.
+ * @param s The first vertex, above the first separator row.
+ * @param t The second vertex, below the second separator row.
+ * @return The length of the shortest path between s and t.
+ */
+int oracle_via_separators(const t_oracle &O, int k, int k2, int s, int t) {
+    const int* dis_s = O.dis + ((size_t)s * 2 + 1) * O.dim;
+    const int* dis_t = O.dis + ((size_t)t * 2) * O.dim;
+    const int* sep_dis = O.sep_dis + sep_pair(O.n_sep, k, k2) * O.dim * O.dim;
+
+    // dis_l[l] is the distance from s to the l-th vertex of the second separator row,
+    // it is bounded by INF before the distance to t is added, so that three INF are never added up
+    vector<int> dis_l(O.dim, INF);
+    for (int j = 0; j < O.dim; j++) {
+        if (dis_s[j] >= INF) continue;
+        const int* sep_dis_j = sep_dis + (size_t)j * O.dim;
+        for (int l = 0; l < O.dim; l++)
+            dis_l[l] = min(dis_l[l], dis_s[j] + sep_dis_j[l]);
+    }
+
+    int best = INF;
+    for (int l = 0; l < O.dim; l++)
+        best = min(best, min(dis_l[l], INF) + dis_t[l]);
+    return min(best, INF);
+}
+
+/**
+ * @brief Calculates the distance between two vertices lying strictly between
+ * two consecutive separator rows, using only the rows between them.
+ *
+ * @param O The distance oracle.
+ * @param top The first row that may be used.
+ * @param bottom The last row that may be used.
+ * @param s The source vertex.
+ * @param t The target vertex.
+ * @param bound Paths not shorter than this bound are ignored.
+ * @return The length of the shortest path inside the rows, or bound if there is no shorter one.
+ */
+int oracle_local_search(const t_oracle &O, int top, int bottom, int s, int t, int bound) {
+    int begin_vtx = top * O.dim; // First vertex of the stripe
+    vector<int> D((bottom - top + 1) * O.dim, bound);
+    priority_queue<t_queue_Node> pq; // Min-heap to store vertices based on distance
+
+    D[s - begin_vtx] = 0;
+    pq.push(t_queue_Node(s, 0));
+    while (!pq.empty()) {
+        t_queue_Node current = pq.top();    pq.pop();
+        int vtx = current.vex;
+        if (current.dis > D[vtx - begin_vtx]) continue; // Outdated entry
+        if (vtx == t) return current.dis;
+
+        int row = vtx / O.dim, col = vtx % O.dim;
+        // Relax the four neighbors inside the stripe
+        int next_vtx[4], length[4], n_next = 0;
+        if (col > 0)            next_vtx[n_next] = vtx - 1,     length[n_next++] = O.row_w[vtx - 1];
+        if (col + 1 < O.dim)    next_vtx[n_next] = vtx + 1,     length[n_next++] = O.row_w[vtx];
+        if (row > top)          next_vtx[n_next] = vtx - O.dim, length[n_next++] = O.col_w[vtx - O.dim];
+        if (row < bottom)       next_vtx[n_next] = vtx + O.dim, length[n_next++] = O.col_w[vtx];
+        for (int i = 0; i < n_next; i++) {
+            int new_dis = current.dis + length[i];
+            if (new_dis < D[next_vtx[i] - begin_vtx]) {
+                D[next_vtx[i] - begin_vtx] = new_dis;
+                pq.push(t_queue_Node(next_vtx[i], new_dis));
+            }
+        }
+    }
+    return bound;
+}
+
+/**
+ * @brief Answers a point-to-point shortest distance query with the distance oracle.
+ *
+ * @param O The distance oracle.
+ * @param s The source vertex.
+ * @param t The target vertex.
+ * @return The shortest distance between s and t, INF if t cannot be reached.
+ */
+int oracle_query(const t_oracle &O, int s, int t) {
+    int lo_vtx = min(s, t), hi_vtx = max(s, t);
+    int lo = lo_vtx / O.dim, hi = hi_vtx / O.dim; // Rows spanned by the query
+
+    // The first separator row not above row lo, and the last one not below row hi
+    int k = down_separator(O, lo), k2 = up_separator(O, hi);
+
+    // One separator row lies between s and t, so every path passes through it
+    if (k == k2) return oracle_via_separator(O, lo_vtx, 1, hi_vtx, 0);
+    // Several separator rows lie between s and t, so every path passes through the first and the last
+    if (k < k2) return oracle_via_separators(O, k, k2, lo_vtx, hi_vtx);
+
+    // Both vertices lie in the same stripe: the shortest path either leaves the
+    // stripe through one of its separator rows or stays inside the stripe
+    int best = min(oracle_via_separator(O, s, 0, t, 0), oracle_via_separator(O, s, 1, t, 1));
+
+    int top = k > 0 ? O.sep_rows[k - 1] + 1 : 0;
+    int bottom = k < O.n_sep ? O.sep_rows[k] - 1 : O.dim - 1;
+    return oracle_local_search(O, top, bottom, s, t, best);
+}
+
+#endif // !_Distance_Oracle_h
@@ -1,21 +1,35 @@
 #include <fstream>
 #include <sstream>
 #include "Global_Var.h"
+#include "Memory_Alloc.h"
 
-int g_src_vtx = 0;         // Source vertex ID
-int g_src_vtx_row = 0;     // Row position of the source vertex
-int g_src_vtx_col = 0;     // Column position of the source vertex
+thread_local int g_src_vtx = 0;         // Source vertex ID
+thread_local int g_src_vtx_row = 0;     // Row position of the source vertex
+thread_local int g_src_vtx_col = 0;     // Column position of the source vertex
 
-int g_dim = 50;             // Dimension of the graph (e.g., a graph is g_dim * g_dim square)
-int g_n_vtx = 50 * 50;      // Total number of vertices in the graph
+thread_local int g_dim = 50;             // Dimension of the graph (e.g., a graph is g_dim * g_dim square)
+thread_local int g_n_vtx = 50 * 50;      // Total number of vertices in the graph
 int** g_arcs = NULL;        // Distance matrix representing the weights of edges between vertices
 vector<vector<int>> g_neighbor; // Adjacency list for graph neighbors
+thread_local int* g_row_w = NULL;        // Weight plane of the horizontal edges, g_row_w[v] is the length of edge (v, v + 1)
+thread_local int* g_col_w = NULL;        // Weight plane of the vertical edges, g_col_w[v] is the length of edge (v, v + g_dim)
+thread_local uint64_t* g_cell_mask = NULL; // Bitset of the open vertices, i.e. the vertices with at least one edge
+thread_local uint64_t* g_row_mask = NULL;  // Bitset of the horizontal edges, bit v is set if edge (v, v + 1) exists
 string PROBLEM_PATH = ""; 	// Path to the problem file
 
 int* g_parent = NULL;       // Array to store the parent of each vertex in the shortest path tree
 int* g_shortest_dis = NULL; // Array to store the shortest distance from the source vertex to each vertex
 
 int g_repeat_time = 0;      // Number of repetitions for each algorithm
+int g_run_dijkstra = 1;     // Whether Dijkstra's algorithm is run as a time baseline (1) or not (0)
+
+int g_oracle_stride = 0;    // Number of rows between two separator rows of the oracle
+string ORACLE_PATH = "";    // Path to the oracle file (built and saved if it does not exist)
+
+int g_radius = -1;          // Only the vertices within this distance of the source vertex are searched
+
+int g_dim_z = 1;            // Number of planes of a 3D mesh
+int g_src_vtx_plane = 0;    // Plane position of the source vertex
 
 /**
  * @brief Reads parameters from a configuration file.
@@ -40,12 +54,32 @@ void get_parameter(string config_path) {
         // Parse the parameters based on expected keywords
         if (tmp == "DIMENSION:") tmp_line >> g_dim;
         else if (tmp == "REPEAT_TIME:") tmp_line >> g_repeat_time;
+        else if (tmp == "RUN_DIJKSTRA:") tmp_line >> g_run_dijkstra;
         else if (tmp == "INSTANCE_PATH:") tmp_line >> PROBLEM_PATH;
         else if (tmp == "SOURCE_VERTEX_ROW:") tmp_line >> g_src_vtx_row;
         else if (tmp == "SOURCE_VERTEX_COLUMN:") tmp_line >> g_src_vtx_col;
+        else if (tmp == "DIMENSION_Z:") tmp_line >> g_dim_z;
+        else if (tmp == "SOURCE_VERTEX_PLANE:") tmp_line >> g_src_vtx_plane;
+        else if (tmp == "ORACLE_STRIDE:") tmp_line >> g_oracle_stride;
+        else if (tmp == "ORACLE_PATH:") tmp_line >> ORACLE_PATH;
+        else if (tmp == "RADIUS:") tmp_line >> g_radius;
+        else if (tmp == "PAGE_MODE:") tmp_line >> g_page_mode;
+        else if (tmp == "NUMA_MODE:") tmp_line >> g_numa_mode;
     }
     ifile.close(); // Close the input file
 
+    // The modes index the names of the memory report and select the mapping of alloc_memory
+    if (g_page_mode < PAGE_DEFAULT || g_page_mode > PAGE_EXPLICIT_HUGE) {
+        cout << __FUNCTION__ << endl
+             << "Invalid PAGE_MODE " << g_page_mode << ", expected 0, 1 or 2" << endl;
+        exit(EXIT_FAILURE);
+    }
+    if (g_numa_mode < NUMA_FIRST_TOUCH || g_numa_mode > NUMA_INTERLEAVE) {
+        cout << __FUNCTION__ << endl
+             << "Invalid NUMA_MODE " << g_numa_mode << ", expected 0 or 1" << endl;
+        exit(EXIT_FAILURE);
+    }
+
     g_n_vtx = g_dim * g_dim; // Update the total number of vertices
     g_src_vtx = g_src_vtx_row * g_dim + g_src_vtx_col; // Calculate the source vertex ID
 }
@@ -59,8 +93,14 @@ void allocate_memory() {
         g_arcs[i] = new int[g_n_vtx];
     g_neighbor.resize(g_n_vtx);
 
-    g_parent = new int[g_n_vtx];
-    g_shortest_dis = new int[g_n_vtx];
+    // The arrays swept by RRDP are allocated with the page size and NUMA placement of the config
+    g_row_w = alloc_array<int>(g_n_vtx);
+    g_col_w = alloc_array<int>(g_n_vtx);
+    g_cell_mask = alloc_array<uint64_t>(mask_words(g_n_vtx));
+    g_row_mask = alloc_array<uint64_t>(mask_words(g_n_vtx));
+    g_parent = alloc_array<int>(g_n_vtx);
+    g_shortest_dis = alloc_array<int>(g_n_vtx);
+    fill(g_shortest_dis, g_shortest_dis + g_n_vtx, INF); // RRDP never writes the blocked vertices
 }
 
 /**
@@ -71,6 +111,10 @@ void destroy_memory() {
         delete[] g_arcs[i]; 
     delete[] g_arcs; 
 
-    delete[] g_parent;
-    delete[] g_shortest_dis;
+    free_memory(g_row_w);
+    free_memory(g_col_w);
+    free_memory(g_cell_mask);
+    free_memory(g_row_mask);
+    free_memory(g_parent);
+    free_memory(g_shortest_dis);
 }
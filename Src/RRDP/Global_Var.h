@@ -4,21 +4,32 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <algorithm>
+#include <cstdint>
 using namespace std;
 
-// Define a large value for infinity
-#define INF 1000000
+// Define a large value for infinity, also the length of a missing edge in the weight planes.
+// It is larger than any path length, and INF + INF does not overflow an int.
+#define INF 0x3f3f3f3f
+
+// The variables read by RRDP are thread-local, so that every worker thread
+// of the server can bind its own graph, source vertex and workspace
 
 // Source vertex information
-extern int g_src_vtx;         // Source vertex ID
-extern int g_src_vtx_row;     // Row position of the source vertex
-extern int g_src_vtx_col;     // Column position of the source vertex
+extern thread_local int g_src_vtx;         // Source vertex ID
+extern thread_local int g_src_vtx_row;     // Row position of the source vertex
+extern thread_local int g_src_vtx_col;     // Column position of the source vertex
 
 // Global parameters related to the graph
-extern int g_dim;             // Dimension of the graph (e.g., a graph is g_dim * g_dim square)
-extern int g_n_vtx;           // Total number of vertices in the graph
+extern thread_local int g_dim;             // Dimension of the graph (e.g., a graph is g_dim * g_dim square)
+extern thread_local int g_n_vtx;           // Total number of vertices in the graph
 extern int** g_arcs;          // Distance matrix representing the weights of edges between vertices
 extern vector<vector<int>> g_neighbor; // Adjacency list for graph neighbors
+extern thread_local int* g_row_w;          // Weight plane of the horizontal edges, g_row_w[v] is the length of edge (v, v + 1)
+extern thread_local int* g_col_w;          // Weight plane of the vertical edges, g_col_w[v] is the length of edge (v, v + g_dim)
+extern thread_local uint64_t* g_cell_mask; // Bitset of the open vertices, i.e. the vertices with at least one edge
+extern thread_local uint64_t* g_row_mask;  // Bitset of the horizontal edges, bit v is set if edge (v, v + 1) exists
+// A missing edge has the length INF in the weight planes, which is how the vertical edges are masked
 extern string PROBLEM_PATH;   // Path to the problem file
 
 // Arrays for storing results related to shortest paths
@@ -27,6 +38,146 @@ extern int* g_shortest_dis;   // Array to store the shortest distance from the s
 
 // Variable to determine how many times to repeat the process
 extern int g_repeat_time;     // Number of repetitions for each algorithm
+extern int g_run_dijkstra;    // Whether Dijkstra's algorithm is run as a time baseline (1) or not (0)
+
+// Parameters of the precomputed distance oracle (disabled when the stride is 0)
+extern int g_oracle_stride;   // Number of rows between two separator rows of the oracle
+extern string ORACLE_PATH;    // Path to the oracle file (built and saved if it does not exist)
+
+// Radius of the bounded RRDP (disabled when negative)
+extern int g_radius;          // Only the vertices within this distance of the source vertex are searched
+
+// Parameters of the 3D meshes (the graph is a 2D mesh when there is only one plane)
+extern int g_dim_z;           // Number of planes of a 3D mesh
+extern int g_src_vtx_plane;   // Plane position of the source vertex
+
+/**
+ * @brief Gets the number of 64-bit words of a bitset.
+ *
+ * @param n_bits The number of bits.
+ * @return The number of words.
+ */
+inline size_t mask_words(size_t n_bits) {
+    return (n_bits + 63) / 64;
+}
+
+/**
+ * @brief Tests a bit of a bitset.
+ *
+ * @param mask The bitset.
+ * @param pos The position of the bit.
+ * @return true if the bit is set.
+ */
+inline bool test_bit(const uint64_t* mask, int pos) {
+    return (mask[pos >> 6] >> (pos & 63)) & 1;
+}
+
+/**
+ * @brief Finds the first set bit of a bitset in [from, to), scanning a word at a time.
+ *
+ * @param mask The bitset.
+ * @param from The first position to be scanned.
+ * @param to The position after the last position to be scanned.
+ * @return The position of the bit, to if there is none.
+ */
+inline int next_set_bit(const uint64_t* mask, int from, int to) {
+    if (from >= to) return to;
+    int word_idx = from >> 6;
+    uint64_t word = mask[word_idx] & (~0ULL << (from & 63)); // Drop the bits before from
+    while (word == 0) {
+        if ((++word_idx << 6) >= to) return to;
+        word = mask[word_idx];
+    }
+    return min((word_idx << 6) + __builtin_ctzll(word), to);
+}
+
+/**
+ * @brief Finds the first clear bit of a bitset in [from, to), scanning a word at a time.
+ *
+ * @param mask The bitset.
+ * @param from The first position to be scanned.
+ * @param to The position after the last position to be scanned.
+ * @return The position of the bit, to if there is none.
+ */
+inline int next_clear_bit(const uint64_t* mask, int from, int to) {
+    if (from >= to) return to;
+    int word_idx = from >> 6;
+    uint64_t word = ~mask[word_idx] & (~0ULL << (from & 63)); // Drop the bits before from
+    while (word == 0) {
+        if ((++word_idx << 6) >= to) return to;
+        word = ~mask[word_idx];
+    }
+    return min((word_idx << 6) + __builtin_ctzll(word), to);
+}
+
+/**
+ * @brief Gets the length of the edge between two adjacent vertices from the weight planes.
+ *
+ * @param u One endpoint of the edge.
+ * @param v The other endpoint of the edge.
+ * @return The length of the edge, INF if the edge is missing.
+ */
+inline int edge_length(int u, int v) {
+    return (u - v == 1 || v - u == 1) ? g_row_w[min(u, v)] : g_col_w[min(u, v)];
+}
+
+// Weight planes and masks of a graph swept by RRDP. A 3D mesh is a stack of 2D graphs of the same
+// columns, joined by the edges of a third weight plane; a 2D graph is a mesh of one plane.
+struct t_planes {
+    int dim;                    // Number of columns of a row
+    int n_vtx;                  // Total number of vertices in the graph
+    int plane_size;             // Number of vertices of a plane, n_vtx for a 2D graph
+    const int* row_w;           // row_w[v] is the length of edge (v, v + 1)
+    const int* col_w;           // col_w[v] is the length of edge (v, v + dim), INF at the last row of a plane
+    const int* z_w;             // z_w[v] is the length of edge (v, v + plane_size), NULL for a 2D graph
+    const uint64_t* cell_mask;  // Bitset of the open vertices
+    const uint64_t* row_mask;   // Bitset of the horizontal edges
+};
+
+/**
+ * @brief Gets the weight planes and masks of the 2D graph bound to the global variables.
+ *
+ * @return The planes of the graph, without a third plane.
+ */
+inline t_planes get_planes() {
+    t_planes G = {g_dim, g_n_vtx, g_n_vtx, g_row_w, g_col_w, NULL, g_cell_mask, g_row_mask};
+    return G;
+}
+
+/**
+ * @brief Gets the neighbors of a vertex and the lengths of the edges to them from the weight planes.
+ * Only the existing edges are returned. A missing edge, including an edge leaving the graph,
+ * has the length INF in the planes, so the test reads the length that is loaded anyway.
+ *
+ * @param G The weight planes of the graph.
+ * @param vtx The vertex.
+ * @param next_vertices An array of at least 6 elements receiving the neighbors.
+ * @param lengths An array of at least 6 elements receiving the lengths of the edges.
+ * @return The number of neighbors.
+ */
+inline int get_neighbors(const t_planes &G, int vtx, int* next_vertices, int* lengths) {
+    int n_next = 0;
+    if (vtx > 0 && G.row_w[vtx - 1] < INF) { // Left neighbor
+        next_vertices[n_next] = vtx - 1;  lengths[n_next++] = G.row_w[vtx - 1];
+    }
+    if (G.row_w[vtx] < INF) { // Right neighbor
+        next_vertices[n_next] = vtx + 1;  lengths[n_next++] = G.row_w[vtx];
+    }
+    if (vtx >= G.dim && G.col_w[vtx - G.dim] < INF) { // Upper neighbor
+        next_vertices[n_next] = vtx - G.dim;  lengths[n_next++] = G.col_w[vtx - G.dim];
+    }
+    if (G.col_w[vtx] < INF) { // Below neighbor
+        next_vertices[n_next] = vtx + G.dim;  lengths[n_next++] = G.col_w[vtx];
+    }
+    if (G.z_w == NULL) return n_next;
+    if (vtx >= G.plane_size && G.z_w[vtx - G.plane_size] < INF) { // Neighbor in the previous plane
+        next_vertices[n_next] = vtx - G.plane_size;  lengths[n_next++] = G.z_w[vtx - G.plane_size];
+    }
+    if (G.z_w[vtx] < INF) { // Neighbor in the next plane
+        next_vertices[n_next] = vtx + G.plane_size;  lengths[n_next++] = G.z_w[vtx];
+    }
+    return n_next;
+}
 
 /**
  * @brief Reads parameters from a configuration file.
@@ -20,23 +20,29 @@ struct t_queue_Node {
 };
 
 /**
- * @brief Dijkstra's algorithm implementation using a priority queue.
- * 
+ * @brief Dijkstra's algorithm implementation using a priority queue,
+ * on a graph given by a function visiting the neighbors of a vertex.
+ *
+ * @param n_vtx The total number of vertices in the graph.
+ * @param src The source vertex.
  * @param D An array holding the shortest distances from the source vertex.
  * @param P An array holding the predecessor of each vertex in the shortest path.
+ * @param for_each_next Calls relax(next_vertex, length) for each neighbor of a vertex,
+ * as for_each_next(vtx, relax).
  */
-void dijkstra_heap(int* D, int* P) {
+template <typename t_for_each_next>
+void dijkstra_heap(int n_vtx, int src, int* D, int* P, t_for_each_next for_each_next) {
     priority_queue<t_queue_Node> pq; // Min-heap to store vertices based on distance
-    vector<bool> is_sure(g_n_vtx, false); // Array to track finalized vertices
+    vector<bool> is_sure(n_vtx, false); // Array to track finalized vertices
 
     // Initialize all distances to infinity
-    for (int i = 0; i < g_n_vtx; i++) D[i] = INF;
+    for (int i = 0; i < n_vtx; i++) D[i] = INF;
 
     // Set distance for the source vertex and its predecessor
-    D[g_src_vtx] = 0;
-    P[g_src_vtx] = g_src_vtx;
+    D[src] = 0;
+    P[src] = src;
     
-    pq.push(t_queue_Node(g_src_vtx, 0));    // Push the source vertex into the priority queue
+    pq.push(t_queue_Node(src, 0));    // Push the source vertex into the priority queue
     while (!pq.empty()) {   // Process the priority queue until it's empty
         // Get the vertex with the smallest distance from the queue
         t_queue_Node current = pq.top();    pq.pop();
@@ -46,18 +52,46 @@ void dijkstra_heap(int* D, int* P) {
         is_sure[sure_vex] = true;   // Mark the current vertex as finalized
 
         // Iterate through the neighbors of the current vertex
-        for (int vex : g_neighbor[sure_vex]) {
-            if (is_sure[vex]) continue; // Skip if the neighbor is already finalized
+        for_each_next(sure_vex, [&](int vex, int length) {
+            if (is_sure[vex]) return; // Skip if the neighbor is already finalized
 
             // Calculate the new distance
-            int new_dis = D[sure_vex] + g_arcs[sure_vex][vex];
+            int new_dis = D[sure_vex] + length;
             if (new_dis < D[vex]) { // If the new distance is shorter, update it
                 D[vex] = new_dis;
                 P[vex] = sure_vex;
                 pq.push(t_queue_Node(vex, new_dis)); // Push the updated distance into the queue
             }
-        }
+        });
     }
 }
 
+/**
+ * @brief Dijkstra's algorithm on the current graph, with its adjacency list and distance matrix.
+ * 
+ * @param D An array holding the shortest distances from the source vertex.
+ * @param P An array holding the predecessor of each vertex in the shortest path.
+ */
+void dijkstra_heap(int* D, int* P) {
+    dijkstra_heap(g_n_vtx, g_src_vtx, D, P, [](int vtx, auto relax) {
+        for (int vex : g_neighbor[vtx]) relax(vex, g_arcs[vtx][vex]);
+    });
+}
+
+/**
+ * @brief Dijkstra's algorithm on the weight planes of a graph, such as a 3D mesh.
+ *
+ * @param G The weight planes of the graph.
+ * @param src The source vertex.
+ * @param D An array holding the shortest distances from the source vertex.
+ * @param P An array holding the predecessor of each vertex in the shortest path.
+ */
+void dijkstra_heap(const t_planes &G, int src, int* D, int* P) {
+    dijkstra_heap(G.n_vtx, src, D, P, [&G](int vtx, auto relax) {
+        int next_vertices[6], lengths[6]; // Neighbors of the vertex
+        int n_next = get_neighbors(G, vtx, next_vertices, lengths);
+        for (int i = 0; i < n_next; i++) relax(next_vertices[i], lengths[i]);
+    });
+}
+
 #endif // !_Heap_Dijkstra_h
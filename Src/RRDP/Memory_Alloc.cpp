@@ -0,0 +1,174 @@
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <string>
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+
+#include "Memory_Alloc.h"
+using namespace std;
+
+int g_page_mode = PAGE_DEFAULT;     // Page size used for the arrays (t_page_mode)
+int g_numa_mode = NUMA_FIRST_TOUCH; // Placement of the arrays on the NUMA nodes (t_numa_mode)
+
+static map<void*, size_t> mapped_len; // Length of the mapping of each allocated array
+static mutex mapped_lock;             // Protects mapped_len, the server allocates from several threads
+static atomic<int> page_mode_used(PAGE_EXPLICIT_HUGE); // Smallest page size any allocation fell back to
+static atomic<int> numa_mode_used(NUMA_INTERLEAVE);    // Placement any allocation fell back to
+
+/**
+ * @brief Records that an allocation did not get the page size or placement asked for,
+ * and warns about it the first time.
+ *
+ * @param mode_used page_mode_used or numa_mode_used.
+ * @param mode The page mode or NUMA mode actually used.
+ * @param message The warning.
+ */
+static void fall_back(atomic<int> &mode_used, int mode, string message) {
+    int old_mode = mode_used.load();
+    while (mode < old_mode && !mode_used.compare_exchange_weak(old_mode, mode));
+    if (mode < old_mode)
+        cout << "alloc_memory" << endl
+             << message << endl;
+}
+
+/**
+ * @brief Reads the mask of the online NUMA nodes.
+ *
+ * @return The mask of the online NUMA nodes, 0 if it cannot be read.
+ */
+static unsigned long get_online_nodes() {
+    ifstream ifile("/sys/devices/system/node/online"); // List of ranges, such as "0-1,3"
+    if (ifile.fail()) return 0;
+
+    unsigned long mask = 0;
+    int first = 0, last = 0;
+    char sep = 0;
+    while (ifile >> first) {
+        last = first;
+        if (ifile.peek() == '-') ifile >> sep >> last;
+        for (int node = first; node <= last && node < (int)(8 * sizeof(mask)); node++)
+            mask |= 1UL << node;
+        if (ifile.peek() == ',') ifile >> sep;
+    }
+    ifile.close();
+    return mask;
+}
+
+/**
+ * @brief Maps anonymous memory aligned on a huge page and asks for transparent huge pages.
+ *
+ * @param len The length of the mapping, a multiple of HUGE_PAGE_SIZE.
+ * @return The address of the mapping, MAP_FAILED on failure.
+ */
+static void* map_transparent_huge(size_t len) {
+    // Map one more huge page and trim both ends to get an aligned mapping
+    char* raw = (char*)mmap(NULL, len + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) return MAP_FAILED;
+
+    char* addr = (char*)(((size_t)raw + HUGE_PAGE_SIZE - 1) & ~(size_t)(HUGE_PAGE_SIZE - 1));
+    if (addr > raw) munmap(raw, addr - raw);
+    munmap(addr + len, raw + HUGE_PAGE_SIZE - addr);
+    if (madvise(addr, len, MADV_HUGEPAGE) != 0)
+        fall_back(page_mode_used, PAGE_DEFAULT, "Transparent huge pages are not available, use normal pages instead");
+    return addr;
+}
+
+/**
+ * @brief Allocates a zero-filled array aligned on a cache line with the page
+ * size and NUMA placement given by g_page_mode and g_numa_mode.
+ * The pages are touched by the calling thread, so that with first-touch placement
+ * they are local to the thread sweeping them and no page fault happens later.
+ *
+ * @param n_bytes The size of the array in bytes.
+ * @return The address of the array.
+ */
+void* alloc_memory(size_t n_bytes) {
+    int page_mode = g_page_mode; // Set once at startup, only read here
+    size_t page_size = page_mode == PAGE_DEFAULT ? (size_t)sysconf(_SC_PAGESIZE) : HUGE_PAGE_SIZE;
+    size_t len = (max(n_bytes, (size_t)CACHE_LINE_SIZE) + page_size - 1) / page_size * page_size;
+    void* addr = MAP_FAILED;
+
+    if (page_mode == PAGE_EXPLICIT_HUGE) {
+        addr = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (addr == MAP_FAILED) { // The hugetlbfs pool is empty, fall back to transparent huge pages
+            fall_back(page_mode_used, PAGE_TRANSPARENT_HUGE,
+                      "No explicit huge page available, use transparent huge pages instead");
+            page_mode = PAGE_TRANSPARENT_HUGE;
+        }
+    }
+    if (addr == MAP_FAILED && page_mode == PAGE_TRANSPARENT_HUGE)
+        addr = map_transparent_huge(len);
+    if (addr == MAP_FAILED && page_mode == PAGE_DEFAULT)
+        addr = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (addr == MAP_FAILED) {
+        cout << __FUNCTION__ << endl
+             << "Fail to allocate " << n_bytes << " bytes" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // Interleave the pages over the nodes before they are touched
+    if (g_numa_mode == NUMA_INTERLEAVE) {
+        unsigned long nodes = get_online_nodes();
+        if (nodes == 0)
+            fall_back(numa_mode_used, NUMA_FIRST_TOUCH, "Cannot read the NUMA nodes, use first-touch placement instead");
+        else if ((nodes & (nodes - 1)) == 0)
+            fall_back(numa_mode_used, NUMA_FIRST_TOUCH, "Only one NUMA node, use first-touch placement instead");
+        else if (syscall(SYS_mbind, addr, len, MPOL_INTERLEAVE, &nodes, 8 * sizeof(nodes), 0) != 0)
+            fall_back(numa_mode_used, NUMA_FIRST_TOUCH,
+                      string("Fail to interleave the pages over the NUMA nodes (") + strerror(errno)
+                      + "), use first-touch placement instead");
+    }
+
+    memset(addr, 0, len); // First touch
+    lock_guard<mutex> guard(mapped_lock);
+    mapped_len[addr] = len;
+    return addr;
+}
+
+/**
+ * @brief Gets the page size actually used by the allocations, which is smaller than
+ * g_page_mode if any allocation fell back to smaller pages.
+ *
+ * @return The page mode (t_page_mode).
+ */
+int used_page_mode() {
+    return min(g_page_mode, page_mode_used.load());
+}
+
+/**
+ * @brief Gets the NUMA placement actually used by the allocations, which is first-touch
+ * if g_numa_mode asks to interleave but any allocation could not be interleaved.
+ *
+ * @return The NUMA mode (t_numa_mode).
+ */
+int used_numa_mode() {
+    return min(g_numa_mode, numa_mode_used.load());
+}
+
+/**
+ * @brief Deallocates an array allocated by alloc_memory.
+ *
+ * @param ptr The address of the array, may be NULL.
+ */
+void free_memory(void* ptr) {
+    if (ptr == NULL) return;
+
+    size_t len = 0;
+    {
+        lock_guard<mutex> guard(mapped_lock);
+        map<void*, size_t>::iterator it = mapped_len.find(ptr);
+        if (it == mapped_len.end()) return; // Not allocated by alloc_memory
+        len = it->second;
+        mapped_len.erase(it);
+    }
+    munmap(ptr, len);
+}
@@ -0,0 +1,72 @@
+#ifndef _Memory_Alloc_h
+#define _Memory_Alloc_h
+
+#include <cstddef>
+
+// Alignment of every array, so that no array shares a cache line with another one
+#define CACHE_LINE_SIZE 64
+// Size of a huge page on x86-64
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+// Page size used for the arrays
+enum t_page_mode {
+    PAGE_DEFAULT = 0,           // Normal pages
+    PAGE_TRANSPARENT_HUGE = 1,  // Transparent huge pages (madvise)
+    PAGE_EXPLICIT_HUGE = 2      // Explicit huge pages from the hugetlbfs pool
+};
+
+// Placement of the arrays on the NUMA nodes
+enum t_numa_mode {
+    NUMA_FIRST_TOUCH = 0,       // Pages are placed on the node of the thread touching them first
+    NUMA_INTERLEAVE = 1         // Pages are interleaved over all nodes
+};
+
+extern int g_page_mode;       // Page size used for the arrays (t_page_mode)
+extern int g_numa_mode;       // Placement of the arrays on the NUMA nodes (t_numa_mode)
+
+/**
+ * @brief Allocates a zero-filled array aligned on a cache line with the page
+ * size and NUMA placement given by g_page_mode and g_numa_mode.
+ * The pages are touched by the calling thread, so that with first-touch placement
+ * they are local to the thread sweeping them and no page fault happens later.
+ *
+ * @param n_bytes The size of the array in bytes.
+ * @return The address of the array.
+ */
+void* alloc_memory(size_t n_bytes);
+
+/**
+ * @brief Gets the page size actually used by the allocations, which is smaller than
+ * g_page_mode if any allocation fell back to smaller pages.
+ *
+ * @return The page mode (t_page_mode).
+ */
+int used_page_mode();
+
+/**
+ * @brief Gets the NUMA placement actually used by the allocations, which is first-touch
+ * if g_numa_mode asks to interleave but any allocation could not be interleaved.
+ *
+ * @return The NUMA mode (t_numa_mode).
+ */
+int used_numa_mode();
+
+/**
+ * @brief Deallocates an array allocated by alloc_memory.
+ *
+ * @param ptr The address of the array, may be NULL.
+ */
+void free_memory(void* ptr);
+
+/**
+ * @brief Allocates a zero-filled array of n elements with alloc_memory.
+ *
+ * @param n The number of elements.
+ * @return The address of the array.
+ */
+template <typename T>
+T* alloc_array(size_t n) {
+    return (T*)alloc_memory(n * sizeof(T));
+}
+
+#endif // !_Memory_Alloc_h
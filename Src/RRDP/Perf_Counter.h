@@ -0,0 +1,57 @@
+#ifndef _Perf_Counter_h
+#define _Perf_Counter_h
+
+#include <cstring>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+/**
+ * @brief Opens a hardware counter of the data TLB load misses of the calling thread.
+ *
+ * @return The file descriptor of the counter, -1 if the counter is not available
+ * (e.g. virtual machines or a restrictive perf_event_paranoid).
+ */
+int open_tlb_counter() {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CACHE_DTLB
+                | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+/**
+ * @brief Resets and starts a counter.
+ *
+ * @param fd The file descriptor of the counter, ignored if it is -1.
+ */
+void start_counter(int fd) {
+    if (fd < 0) return;
+    ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+}
+
+/**
+ * @brief Stops a counter and reads its value.
+ *
+ * @param fd The file descriptor of the counter.
+ * @return The value of the counter, -1 if the counter is not available.
+ */
+long long stop_counter(int fd) {
+    if (fd < 0) return -1;
+    ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+
+    long long count = 0;
+    if (read(fd, &count, sizeof(count)) != sizeof(count)) return -1;
+    return count;
+}
+
+#endif // !_Perf_Counter_h
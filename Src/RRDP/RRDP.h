@@ -3,216 +3,301 @@
 
 #include "Heap_Dijkstra.h"
 
+// The present vertices, i.e. the vertices processed already:
+// the open vertices of the planes processed and of the rows processed in the current plane.
+// Both are ranges of vertices, since the planes and the rows are processed outwards from the source vertex.
+struct t_present {
+    int plane_begin, plane_end; // The vertices of the planes processed, an empty range in 2D
+    int row_begin, row_end;     // The vertices of the rows processed in the current plane
+};
+
+/**
+ * @brief Checks if a vertex is present. Only open vertices are tested,
+ * since the blocked vertices have no edges.
+ *
+ * @param R The present vertices.
+ * @param vtx The vertex.
+ * @return True if the vertex is present, false otherwise.
+ */
+inline bool is_present(const t_present &R, int vtx) {
+    return (vtx >= R.row_begin && vtx < R.row_end) || (vtx >= R.plane_begin && vtx < R.plane_end);
+}
+
+/**
+ * @brief Queues a vertex whose tentative shortest path value is reduced.
+ * The vertex goes to the front of the queue if its value is smaller than that of the front vertex
+ * (the smallest label first rule), so that a detour around blocked vertices is not traced again
+ * every time a shorter path reaches it.
+ *
+ * @param Q The queue of vertices to be processed.
+ * @param D An array holding the shortest distances from the source vertex.
+ * @param vtx The vertex.
+ */
+inline void push_vertex(deque<int> &Q, const int* D, int vtx) {
+    if (!Q.empty() && D[vtx] < D[Q.front()]) Q.push_front(vtx);
+    else Q.push_back(vtx);
+}
+
 /**
  * @brief Traces the changes caused by the vertices in the queue,
  * Since their tentative shortest path value are reduced.
  * 
+ * @param G The weight planes of the graph.
  * @param Q The queue of vertices to be processed.
- * @param is_present A boolean array indicating the presence of vertices.
+ * @param R The present vertices.
  * @param D An array holding the shortest distances from the source vertex.
  * @param P An array holding the predecessor of each vertex in the shortest path.
  */
-void trace_change(queue<int> &Q, bool* is_present, int* D, int* P) {
-    int cur_vtx, tmp_cost;
+void trace_change(const t_planes &G, deque<int> &Q, const t_present &R, int* D, int* P) {
+    int cur_vtx, next_vertex, tmp_cost, n_next;
+    int next_vertices[6], lengths[6]; // Neighbors of the current vertex
 
     while (!Q.empty()) { // Process the queue until it's empty
-        cur_vtx = Q.front(); Q.pop(); // Pop a vertex from the queue
+        cur_vtx = Q.front(); Q.pop_front(); // Pop a vertex from the queue
 
         // Iterate through the neighbors of the current vertex
-        for (int next_vertex : g_neighbor[cur_vtx]) {
-            if (!is_present[next_vertex]) continue; // Skip if the vertex is not present
+        n_next = get_neighbors(G, cur_vtx, next_vertices, lengths);
+        for (int i = 0; i < n_next; i++) {
+            next_vertex = next_vertices[i];
+            if (!is_present(R, next_vertex)) continue; // Skip if the vertex is not present
 
             // Calculate the new cost to reach the vertex
-            tmp_cost = D[cur_vtx] + g_arcs[cur_vtx][next_vertex];
+            tmp_cost = D[cur_vtx] + lengths[i];
             // Update if the new cost is lower
             if (tmp_cost < D[next_vertex]) {
                 D[next_vertex] = tmp_cost;
                 P[next_vertex] = cur_vtx;
-                Q.push(next_vertex); // Add the vertex to the queue for further processing
+                push_vertex(Q, D, next_vertex); // Add the vertex to the queue for further processing
             }
         }    
     }
 }
 
 /**
- * @brief Implements the RRDP algorithm to find shortest paths from a source vertex.
- * 
+ * @brief Calculates the new cost of a vertex from its neighbor in the previous plane,
+ * and updates the vertex if it is lower.
+ *
  * @param D An array holding the shortest distances from the source vertex.
  * @param P An array holding the predecessor of each vertex in the shortest path.
+ * @param vtx The vertex.
+ * @param plane_offset The offset from the vertex to its neighbor in the previous plane.
+ * @param plane_lengths The weight plane of the edges to the previous plane,
+ * the edge between them is stored at the lower of the two vertices.
  */
-void rrdp(int* D, int* P) {
-    bool* is_present = new bool[g_n_vtx]; // Track if vertices are present
-    memset(is_present, false, g_n_vtx * sizeof(bool)); // Initialize to false
+inline void pull_from_plane(int* D, int* P, int vtx, int plane_offset, const int* plane_lengths) {
+    int pre_vtx = vtx + plane_offset, tmp_cost = D[pre_vtx] + plane_lengths[min(vtx, pre_vtx)];
+    if (tmp_cost < D[vtx]) { // Update if the new cost is lower
+        D[vtx] = tmp_cost; P[vtx] = pre_vtx;
+    }
+}
 
-    int* row_lengths = new int[g_dim];  // Arrays to hold lengths of horizontal edges among one row
-    int* col_lengths = new int[g_dim];  // Arrays to hold lengths of vertical edges between two rows
+/**
+ * @brief Calculates the new cost of the neighbor of a vertex in the previous plane from the vertex,
+ * and queues the neighbor if its cost is lower.
+ *
+ * @param Q The queue of vertices to be processed.
+ * @param D An array holding the shortest distances from the source vertex.
+ * @param P An array holding the predecessor of each vertex in the shortest path.
+ * @param vtx The vertex.
+ * @param plane_offset The offset from the vertex to its neighbor in the previous plane.
+ * @param plane_lengths The weight plane of the edges to the previous plane,
+ * the edge between them is stored at the lower of the two vertices.
+ */
+inline void push_to_plane(deque<int> &Q, int* D, int* P, int vtx, int plane_offset, const int* plane_lengths) {
+    int pre_vtx = vtx + plane_offset, tmp_cost = D[vtx] + plane_lengths[min(vtx, pre_vtx)];
+    if (tmp_cost < D[pre_vtx]) { // Update if the new cost is lower
+        D[pre_vtx] = tmp_cost; P[pre_vtx] = vtx;
+        push_vertex(Q, D, pre_vtx);
+    }
+}
 
-    queue<int> Q; // Queue for processing vertices
-    int col, row;
+/**
+ * @brief Processes one row from the row processed just before it, and traces the changes.
+ * The row is split into open segments, i.e. runs of open vertices joined by horizontal edges,
+ * which are found a word of the masks at a time, so that the blocked runs are skipped:
+ * the distances of the blocked vertices are never written, and must be INF in D.
+ * Each segment is swept from left to right, then from right to left.
+ * In a 3D mesh, the row is also updated from its neighbors in the previous plane, and updates them.
+ *
+ * @param G The weight planes of the graph.
+ * @param Q The queue of vertices to be processed.
+ * @param R The present vertices, including the row to be processed.
+ * @param D An array holding the shortest distances from the source vertex.
+ * @param P An array holding the predecessor of each vertex in the shortest path.
+ * @param cur_begin_vtx The first vertex of the row to be processed.
+ * @param pre_begin_vtx The first vertex of the row processed just before.
+ * @param pre_lengths The weight plane of the edges to the previous row,
+ * each edge being stored at the lower of its two vertices.
+ * @param plane_offset The offset from a vertex of this row to its neighbor in the previous plane.
+ * @param plane_lengths The weight plane of the edges to the previous plane, stored in the same way,
+ * NULL if there is no previous plane.
+ */
+void sweep_row(const t_planes &G, deque<int> &Q, const t_present &R, int* D, int* P,
+               int cur_begin_vtx, int pre_begin_vtx, const int* pre_lengths,
+               int plane_offset, const int* plane_lengths) {
+    int cur_end_vtx = cur_begin_vtx + G.dim;         // The vertex after the last vertex of this row
+    int pre_offset = pre_begin_vtx - cur_begin_vtx;  // From a vertex of this row to its neighbor in the previous row
+    int pre_len_offset = min(pre_offset, 0);         // From a vertex of this row to its edge to the previous row in pre_lengths
+    const uint64_t* cell_mask = G.cell_mask;
+    const uint64_t* row_mask = G.row_mask;
+    const int* row_lengths = G.row_w;               // Lengths of horizontal edges, row_lengths[vtx] is the edge (vtx, vtx + 1)
+    int seg_begin, seg_end;
     int tmp_cost1, tmp_cost2;
     int vtx, tmp_vtx1, tmp_vtx2;
-    int pre_begin_vtx, cur_begin_vtx;
-
-    // Initialize the source vertex distance and predecessor
-    D[g_src_vtx] = 0;
-    P[g_src_vtx] = g_src_vtx;
-    is_present[g_src_vtx] = true;
 
-    // *****************************************************************************************************
-    // Process the row containing the source vertex
-    // Process from right to left
-    vtx = g_src_vtx - 1;    
-    tmp_vtx1 = g_src_vtx;
-    for (col = g_src_vtx_col - 1; col >= 0; --col) {
-        is_present[vtx] = true;
-
-        // Update distance and predecessor for the vertex
-        D[vtx] = D[tmp_vtx1] + g_arcs[tmp_vtx1][vtx];    
-        P[vtx] = tmp_vtx1;
-        --tmp_vtx1, --vtx;
-    }
+    for (seg_begin = next_set_bit(cell_mask, cur_begin_vtx, cur_end_vtx); seg_begin < cur_end_vtx;
+         seg_begin = next_set_bit(cell_mask, seg_end + 1, cur_end_vtx)) {
+        // The segment ends at the first vertex without a right edge, at the latest in the last column
+        seg_end = next_clear_bit(row_mask, seg_begin, cur_end_vtx);
 
-    // Process from left to right
-    vtx = g_src_vtx + 1;
-    tmp_vtx1 = g_src_vtx;
-    for (col = g_src_vtx_col + 1; col < g_dim; ++col) {
-        is_present[vtx] = true;
-
-        // Update distance and predecessor for the vertex
-        D[vtx] = D[tmp_vtx1] + g_arcs[tmp_vtx1][vtx];
-        P[vtx] = tmp_vtx1;
-        ++tmp_vtx1, ++vtx;
-    }
-    // *****************************************************************************************************
-
-    // *****************************************************************************************************
-    // Process the rows below the source vertex
-    cur_begin_vtx = g_src_vtx - g_src_vtx_col;
-    for (row = g_src_vtx_row + 1; row < g_dim; ++row) {
-        // Update the first vertices in rows that just be processed and will be processed
-        pre_begin_vtx = cur_begin_vtx;
-        cur_begin_vtx += g_dim;
-
-        is_present[cur_begin_vtx] = true; // Mark the vertex as present
-        col_lengths[0] = g_arcs[pre_begin_vtx][cur_begin_vtx]; // Record the column length
-        // Update distance and predecessor for the first vertex in this row
-        D[cur_begin_vtx] = D[pre_begin_vtx] + col_lengths[0];
-        P[cur_begin_vtx] = pre_begin_vtx;
+        // Update distance and predecessor for the first vertex in this segment.
+        // A missing edge has the length INF, and the distances of the vertices not reached are bounded by INF.
+        vtx = seg_begin;
+        tmp_vtx2 = vtx + pre_offset;
+        D[vtx] = min(D[tmp_vtx2] + pre_lengths[vtx + pre_len_offset], INF);
+        P[vtx] = tmp_vtx2;
+        if (plane_lengths) pull_from_plane(D, P, vtx, plane_offset, plane_lengths);
 
         // Process from left to right
-        vtx = cur_begin_vtx;
-        tmp_vtx2 = pre_begin_vtx;
-        for (col = 1; col < g_dim; ++col) {
+        while (vtx < seg_end) {
             tmp_vtx1 = vtx++;
             ++tmp_vtx2;
 
-            is_present[vtx] = true; // Mark the vertex as present
-            row_lengths[col] = g_arcs[vtx][tmp_vtx1]; // Record the row length
-            col_lengths[col] = g_arcs[vtx][tmp_vtx2]; // Record the column length
-            tmp_cost1 = D[tmp_vtx1] + row_lengths[col]; // New cost from the left neighbor
-            tmp_cost2 = D[tmp_vtx2] + col_lengths[col]; // New cost from above neighbor
+            tmp_cost1 = D[tmp_vtx1] + row_lengths[tmp_vtx1]; // New cost from the left neighbor
+            tmp_cost2 = D[tmp_vtx2] + pre_lengths[vtx + pre_len_offset]; // New cost from the neighbor in the previous row
             // Update based on the lower cost
             if (tmp_cost1 < tmp_cost2) {
-                D[vtx] = tmp_cost1;  P[vtx] = tmp_vtx1;
+                D[vtx] = min(tmp_cost1, INF);  P[vtx] = tmp_vtx1;
             } else {
-                D[vtx] = tmp_cost2;  P[vtx] = tmp_vtx2;
+                D[vtx] = min(tmp_cost2, INF);  P[vtx] = tmp_vtx2;
             }
+            if (plane_lengths) pull_from_plane(D, P, vtx, plane_offset, plane_lengths);
         }
 
-        // For the vertex in the previous row, calculate the new cost from the below neighbor
-        tmp_cost2 = D[vtx] + col_lengths[--col];
+        // For the vertex in the previous row, calculate the new cost from this row
+        tmp_cost2 = D[vtx] + pre_lengths[vtx + pre_len_offset];
         if (tmp_cost2 < D[tmp_vtx2]) {	// Update if the new cost is lower
             D[tmp_vtx2] = tmp_cost2; P[tmp_vtx2] = vtx;
-            Q.push(tmp_vtx2);
+            push_vertex(Q, D, tmp_vtx2);
         }
+        if (plane_lengths) push_to_plane(Q, D, P, vtx, plane_offset, plane_lengths);
 
         // Process from right to left
-        for (; col > 0;) {
+        while (vtx > seg_begin) {
             tmp_vtx1 = vtx--;
             --tmp_vtx2;
 
-            tmp_cost1 = D[tmp_vtx1] + row_lengths[col]; // New cost from the right neighbor
+            tmp_cost1 = D[tmp_vtx1] + row_lengths[vtx]; // New cost from the right neighbor
             if (tmp_cost1 < D[vtx]) {
                 D[vtx] = tmp_cost1;  P[vtx] = tmp_vtx1;
             }
 
-			// For the vertex in the previous row
-            tmp_cost2 = D[vtx] + col_lengths[--col]; // New cost from below neighbor
+            // For the vertex in the previous row
+            tmp_cost2 = D[vtx] + pre_lengths[vtx + pre_len_offset]; // New cost from this row
             if (tmp_cost2 < D[tmp_vtx2]) {	// Update if the new cost is lower
                 D[tmp_vtx2] = tmp_cost2; P[tmp_vtx2] = vtx;
-                Q.push(tmp_vtx2);
+                push_vertex(Q, D, tmp_vtx2);
             }
-        } 
-        trace_change(Q, is_present, D, P); // Update distances using trace_change
+            if (plane_lengths) push_to_plane(Q, D, P, vtx, plane_offset, plane_lengths);
+        }
     }
-    // *****************************************************************************************************
+    trace_change(G, Q, R, D, P); // Update distances using trace_change
+}
 
-    // *****************************************************************************************************
-    // Process the rows above the source vertex
-    cur_begin_vtx = g_src_vtx - g_src_vtx_col;
-    for (row = g_src_vtx_row - 1; row >= 0; --row) {
-		// Update the first vertices in rows that just be processed and will be processed
-        pre_begin_vtx = cur_begin_vtx;
-        cur_begin_vtx -= g_dim;
-
-        is_present[cur_begin_vtx] = true; // Mark the vertex as present
-        col_lengths[0] = g_arcs[pre_begin_vtx][cur_begin_vtx]; // Record the column length
-        // Update distance and predecessor for the first vertex in this row
-        D[cur_begin_vtx] = D[pre_begin_vtx] + col_lengths[0];
-        P[cur_begin_vtx] = pre_begin_vtx;
+/**
+ * @brief Processes the row containing the source vertex, from the source vertex to its left
+ * and to its right until a missing edge. All the open vertices of the row are present,
+ * those out of the segment of the source vertex are not reached yet.
+ *
+ * @param G The weight planes of the graph.
+ * @param D An array holding the shortest distances from the source vertex, INF at the blocked vertices.
+ * @param P An array holding the predecessor of each vertex in the shortest path.
+ * @param src The source vertex.
+ */
+void sweep_source_row(const t_planes &G, int* D, int* P, int src) {
+    int cur_begin_vtx = src - src % G.dim, cur_end_vtx = cur_begin_vtx + G.dim;
+    int vtx;
 
-        // Process from left to right
-        vtx = cur_begin_vtx;
-        tmp_vtx2 = pre_begin_vtx;
-        for (col = 1; col < g_dim; ++col) {
-            tmp_vtx1 = vtx++;
-            ++tmp_vtx2;
+    for (vtx = next_set_bit(G.cell_mask, cur_begin_vtx, cur_end_vtx); vtx < cur_end_vtx;
+         vtx = next_set_bit(G.cell_mask, vtx + 1, cur_end_vtx))
+        D[vtx] = INF; // Not reached yet
+    D[src] = 0;
+    P[src] = src;
 
-            is_present[vtx] = true; // Mark the vertex as present
-            row_lengths[col] = g_arcs[vtx][tmp_vtx1]; // Record the row length
-            col_lengths[col] = g_arcs[vtx][tmp_vtx2]; // Record the column length
-            tmp_cost1 = D[tmp_vtx1] + row_lengths[col]; // New cost from the left neighbor
-            tmp_cost2 = D[tmp_vtx2] + col_lengths[col]; // New cost from below neighbor
-            // Update based on the lower cost
-            if (tmp_cost1 < tmp_cost2) {
-                D[vtx] = tmp_cost1;  P[vtx] = tmp_vtx1;
-            } else {
-                D[vtx] = tmp_cost2;  P[vtx] = tmp_vtx2;
-            }
-        }
+    // Process from right to left, until a missing edge
+    for (vtx = src - 1; vtx >= cur_begin_vtx && test_bit(G.row_mask, vtx); --vtx) {
+        // Update distance and predecessor for the vertex
+        D[vtx] = D[vtx + 1] + G.row_w[vtx];
+        P[vtx] = vtx + 1;
+    }
 
-        // For the vertex in the previous row, calculate the new cost from the above neighbor
-        tmp_cost2 = D[vtx] + col_lengths[--col];
-        if (tmp_cost2 < D[tmp_vtx2]) {	// Update if the new cost is lower
-            D[tmp_vtx2] = tmp_cost2; P[tmp_vtx2] = vtx;
-            Q.push(tmp_vtx2);
-        }
+    // Process from left to right, until a missing edge
+    for (vtx = src + 1; vtx < cur_end_vtx && test_bit(G.row_mask, vtx - 1); ++vtx) {
+        // Update distance and predecessor for the vertex
+        D[vtx] = D[vtx - 1] + G.row_w[vtx - 1];
+        P[vtx] = vtx - 1;
+    }
+}
 
-        // Process from right to left
-        for (; col > 0;) {
-            tmp_vtx1 = vtx--;
-            --tmp_vtx2;
+/**
+ * @brief Processes the rows of a plane below a start row, then the rows above it,
+ * the start row being processed already. Each row is processed from the row just before it.
+ *
+ * @param G The weight planes of the graph.
+ * @param Q The queue of vertices to be processed.
+ * @param R The present vertices, its rows are set to those of the plane processed.
+ * @param D An array holding the shortest distances from the source vertex.
+ * @param P An array holding the predecessor of each vertex in the shortest path.
+ * @param start_begin_vtx The first vertex of the start row.
+ * @param plane_offset The offset from a vertex of this plane to its neighbor in the previous plane.
+ * @param plane_lengths The weight plane of the edges to the previous plane as in sweep_row, NULL if there is none.
+ */
+void sweep_plane(const t_planes &G, deque<int> &Q, t_present &R, int* D, int* P,
+                 int start_begin_vtx, int plane_offset, const int* plane_lengths) {
+    int plane_begin_vtx = start_begin_vtx - start_begin_vtx % G.plane_size;
+    int plane_end_vtx = plane_begin_vtx + G.plane_size;
+    int cur_begin_vtx;
 
-            tmp_cost1 = D[tmp_vtx1] + row_lengths[col]; // New cost from the right neighbor
-            if (tmp_cost1 < D[vtx]) {
-                D[vtx] = tmp_cost1;  P[vtx] = tmp_vtx1;
-            }
+    R.row_begin = start_begin_vtx;
+    R.row_end = start_begin_vtx + G.dim;
 
-			// For the vertex in the previous row
-            tmp_cost2 = D[vtx] + col_lengths[--col]; // New cost from above neighbor
-            if (tmp_cost2 < D[tmp_vtx2]) {	// Update if the new cost is lower
-                D[tmp_vtx2] = tmp_cost2; P[tmp_vtx2] = vtx;
-                Q.push(tmp_vtx2);
-            }
-        } 
-        trace_change(Q, is_present, D, P); // Update distances using trace_change
+    // *****************************************************************************************************
+    // Process the rows below the start row
+    for (cur_begin_vtx = start_begin_vtx + G.dim; cur_begin_vtx < plane_end_vtx; cur_begin_vtx += G.dim) {
+        R.row_end = cur_begin_vtx + G.dim;
+        // The vertical edge of a vertex to the previous row is stored at the vertex above it
+        sweep_row(G, Q, R, D, P, cur_begin_vtx, cur_begin_vtx - G.dim, G.col_w,
+                  plane_offset, plane_lengths);
     }
     // *****************************************************************************************************
 
-    // Free allocated memory
-    delete[] is_present;
-    delete[] col_lengths;
-    delete[] row_lengths;
+    // *****************************************************************************************************
+    // Process the rows above the start row
+    for (cur_begin_vtx = start_begin_vtx - G.dim; cur_begin_vtx >= plane_begin_vtx; cur_begin_vtx -= G.dim) {
+        R.row_begin = cur_begin_vtx;
+        // The vertical edge of a vertex to the previous row is stored at the vertex itself
+        sweep_row(G, Q, R, D, P, cur_begin_vtx, cur_begin_vtx + G.dim, G.col_w,
+                  plane_offset, plane_lengths);
+    }
+    // *****************************************************************************************************
+}
+
+/**
+ * @brief Implements the RRDP algorithm to find shortest paths from a source vertex.
+ * The vertices that cannot be reached get the distance INF and an undefined predecessor.
+ * The blocked vertices are skipped, so D must hold INF at them, e.g. since its allocation.
+ * Only a blocked source vertex gets a distance, 0, which must be reset before D is reused for another source.
+ * 
+ * @param D An array holding the shortest distances from the source vertex.
+ * @param P An array holding the predecessor of each vertex in the shortest path.
+ */
+void rrdp(int* D, int* P) {
+    t_planes G = get_planes(); // The graph bound to the global variables
+    t_present R = {0, 0, 0, 0}; // No vertex is present yet
+
+    deque<int> Q; // Queue for processing vertices
+    sweep_source_row(G, D, P, g_src_vtx);
+    sweep_plane(G, Q, R, D, P, g_src_vtx - g_src_vtx_col, 0, NULL);
 }
 
 #endif // !_RRDP_h
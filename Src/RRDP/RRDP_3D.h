@@ -0,0 +1,158 @@
+#ifndef _RRDP_3D_h
+#define _RRDP_3D_h
+
+#include <string>
+#include <fstream>
+#include <sstream>
+
+#include "RRDP.h"
+#include "Read_Problem.h"
+#include "Memory_Alloc.h"
+
+// A 3D mesh of dim_z planes of dim_y rows and dim_x columns.
+// Vertex v = (plane * dim_y + row) * dim_x + col, a missing edge has the length INF.
+struct t_mesh {
+    int dim_x;      // Number of columns of a plane
+    int dim_y;      // Number of rows of a plane
+    int dim_z;      // Number of planes
+    int plane_size; // Number of vertices of a plane
+    int n_vtx;      // Total number of vertices in the mesh
+
+    int* x_w;       // x_w[v] is the length of the edge (v, v + 1) in the same row
+    int* y_w;       // y_w[v] is the length of the edge (v, v + dim_x) in the same plane
+    int* z_w;       // z_w[v] is the length of the edge (v, v + plane_size)
+    uint64_t* cell_mask;    // Bitset of the open vertices
+    uint64_t* row_mask;     // Bitset of the edges (v, v + 1)
+};
+
+/**
+ * @brief Gets the weight planes and masks of a 3D mesh, which are swept by the 2D RRDP functions
+ * with the z plane as the third incoming plane.
+ *
+ * @param M The mesh.
+ * @return The planes of the mesh.
+ */
+inline t_planes get_mesh_planes(const t_mesh &M) {
+    t_planes G = {M.dim_x, M.n_vtx, M.plane_size, M.x_w, M.y_w, M.z_w, M.cell_mask, M.row_mask};
+    return G;
+}
+
+/**
+ * @brief Reads a 3D mesh from a problem file, whose first line gives the numbers of
+ * columns, rows and planes, followed by the same vertex lines as a 2D problem file.
+ *
+ * @param file_path The path to the problem file.
+ * @param M The mesh, its weight planes are allocated with alloc_array.
+ * @return true if the file was read, false if it cannot be opened or is not a 3D mesh.
+ */
+bool read_mesh(string file_path, t_mesh &M) {
+    ifstream ifile(file_path.c_str()); // Open the specified file
+    if (ifile.fail()) return false;
+
+    // Read the dimensions of the mesh from the file
+    if (!(ifile >> M.dim_x >> M.dim_y >> M.dim_z) || M.dim_x <= 0 || M.dim_y <= 0 || M.dim_z <= 0) return false;
+    M.plane_size = M.dim_x * M.dim_y;
+    M.n_vtx = M.plane_size * M.dim_z;
+    M.x_w = alloc_array<int>(M.n_vtx);
+    M.y_w = alloc_array<int>(M.n_vtx);
+    M.z_w = alloc_array<int>(M.n_vtx);
+    fill(M.x_w, M.x_w + M.n_vtx, INF); // The edges omitted by the file are missing
+    fill(M.y_w, M.y_w + M.n_vtx, INF);
+    fill(M.z_w, M.z_w + M.n_vtx, INF);
+
+    string line = "";
+    int start_ver = -1, end_ver = -1, length = 0; // Variables to hold the edges
+
+    // Read each line until the end of the file
+    while (getline(ifile, line)) {
+        stringstream tmp_line(line);
+        tmp_line >> start_ver; // Read the start vertex
+
+        // Keep the edges to the next vertex along each axis, the planes keep INF at the borders
+        while (tmp_line >> end_ver >> length) {
+            if (end_ver == start_ver + 1 && end_ver % M.dim_x)
+                M.x_w[start_ver] = length;
+            else if (end_ver == start_ver + M.dim_x && end_ver % M.plane_size >= M.dim_x)
+                M.y_w[start_ver] = length;
+            else if (end_ver == start_ver + M.plane_size && end_ver < M.n_vtx)
+                M.z_w[start_ver] = length;
+        }
+    }
+    ifile.close(); // Close the input file
+
+    M.cell_mask = alloc_array<uint64_t>(mask_words(M.n_vtx));
+    M.row_mask = alloc_array<uint64_t>(mask_words(M.n_vtx));
+    build_masks(get_mesh_planes(M), M.cell_mask, M.row_mask);
+    return true;
+}
+
+/**
+ * @brief Deallocates the weight planes and masks of a 3D mesh.
+ *
+ * @param M The mesh.
+ */
+void destroy_mesh(t_mesh &M) {
+    free_memory(M.x_w);
+    free_memory(M.y_w);
+    free_memory(M.z_w);
+    free_memory(M.cell_mask);
+    free_memory(M.row_mask);
+}
+
+/**
+ * @brief Implements the RRDP algorithm on a 3D mesh, one plane at a time, with the 2D row sweep.
+ * The plane of the source vertex is processed as in 2D, then the planes after it and the planes
+ * before it. The start row of each of these planes is swept from the same row of the previous plane,
+ * and its other rows from the previous row with the previous plane as a third incoming direction,
+ * so the present vertices are all the open vertices of the swept planes and the swept rows of the
+ * current plane, and their distances are exact in the subgraph they induce.
+ * The vertices that cannot be reached get the distance INF and an undefined predecessor.
+ * The blocked vertices are skipped, so D must hold INF at them, e.g. since its allocation.
+ * Only a blocked source vertex gets a distance, 0, which must be reset before D is reused for another source.
+ *
+ * @param M The mesh.
+ * @param src The source vertex.
+ * @param D An array holding the shortest distances from the source vertex.
+ * @param P An array holding the predecessor of each vertex in the shortest path.
+ */
+void rrdp_mesh(const t_mesh &M, int src, int* D, int* P) {
+    t_planes G = get_mesh_planes(M);
+    t_present R = {0, 0, 0, 0}; // No vertex is present yet
+
+    deque<int> Q; // Queue for processing vertices
+    int src_begin_vtx = src - src % M.dim_x; // The first vertex of the row containing the source vertex
+    int src_plane_vtx = src - src % M.plane_size; // The first vertex of the plane containing the source vertex
+    int cur_begin_vtx;
+
+    // Process the plane containing the source vertex as a 2D graph
+    sweep_source_row(G, D, P, src);
+    sweep_plane(G, Q, R, D, P, src_begin_vtx, 0, NULL);
+    R.plane_begin = src_plane_vtx;
+    R.plane_end = src_plane_vtx + M.plane_size;
+
+    // *****************************************************************************************************
+    // Process the planes after the source vertex
+    for (cur_begin_vtx = src_begin_vtx + M.plane_size; cur_begin_vtx < M.n_vtx; cur_begin_vtx += M.plane_size) {
+        R.row_begin = cur_begin_vtx;
+        R.row_end = cur_begin_vtx + M.dim_x;
+        // The edge of a vertex to the previous plane is stored at the vertex in the previous plane
+        sweep_row(G, Q, R, D, P, cur_begin_vtx, cur_begin_vtx - M.plane_size, M.z_w, 0, NULL);
+        sweep_plane(G, Q, R, D, P, cur_begin_vtx, -M.plane_size, M.z_w);
+        R.plane_end += M.plane_size;
+    }
+    // *****************************************************************************************************
+
+    // *****************************************************************************************************
+    // Process the planes before the source vertex
+    for (cur_begin_vtx = src_begin_vtx - M.plane_size; cur_begin_vtx >= 0; cur_begin_vtx -= M.plane_size) {
+        R.row_begin = cur_begin_vtx;
+        R.row_end = cur_begin_vtx + M.dim_x;
+        // The edge of a vertex to the previous plane is stored at the vertex itself
+        sweep_row(G, Q, R, D, P, cur_begin_vtx, cur_begin_vtx + M.plane_size, M.z_w, 0, NULL);
+        sweep_plane(G, Q, R, D, P, cur_begin_vtx, M.plane_size, M.z_w);
+        R.plane_begin -= M.plane_size;
+    }
+    // *****************************************************************************************************
+}
+
+#endif // !_RRDP_3D_h
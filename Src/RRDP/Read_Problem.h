@@ -5,7 +5,38 @@
 #include <fstream>
 #include <sstream>
 #include <algorithm>
+#include <cstring>
 #include "Global_Var.h"
+#include "Memory_Alloc.h"
+
+/**
+ * @brief Builds the bitsets of the open vertices and of the horizontal edges from the weight planes,
+ * in which a missing edge has the length INF. A vertex without any edge is blocked.
+ *
+ * @param G The weight planes of the graph, the masks are not read.
+ * @param cell_mask The bitset of the open vertices, of mask_words(G.n_vtx) words.
+ * @param row_mask The bitset of the horizontal edges, of mask_words(G.n_vtx) words.
+ */
+void build_masks(const t_planes &G, uint64_t* cell_mask, uint64_t* row_mask) {
+    memset(cell_mask, 0, mask_words(G.n_vtx) * sizeof(uint64_t));
+    memset(row_mask, 0, mask_words(G.n_vtx) * sizeof(uint64_t));
+
+    for (int vtx = 0; vtx < G.n_vtx; vtx++) {
+        if (G.row_w[vtx] < INF) { // Edge (vtx, vtx + 1)
+            row_mask[vtx >> 6] |= 1ULL << (vtx & 63);
+            cell_mask[vtx >> 6] |= 1ULL << (vtx & 63);
+            cell_mask[(vtx + 1) >> 6] |= 1ULL << ((vtx + 1) & 63);
+        }
+        if (G.col_w[vtx] < INF) { // Edge (vtx, vtx + dim)
+            cell_mask[vtx >> 6] |= 1ULL << (vtx & 63);
+            cell_mask[(vtx + G.dim) >> 6] |= 1ULL << ((vtx + G.dim) & 63);
+        }
+        if (G.z_w && G.z_w[vtx] < INF) { // Edge (vtx, vtx + plane_size)
+            cell_mask[vtx >> 6] |= 1ULL << (vtx & 63);
+            cell_mask[(vtx + G.plane_size) >> 6] |= 1ULL << ((vtx + G.plane_size) & 63);
+        }
+    }
+}
 
 /**
  * @brief Reads problem data from a specified file.
@@ -23,6 +54,9 @@ void read_problem(string file_path) {
     
     ifile >> g_dim; // Read the dimension of the graph from the file
     g_n_vtx = g_dim * g_dim; // Calculate the total number of vertices
+    // The edges omitted by the file are missing, with the length INF
+    fill(g_row_w, g_row_w + g_n_vtx, INF);
+    fill(g_col_w, g_col_w + g_n_vtx, INF);
 
     string line = "";
     int start_ver = -1, end_ver = -1; // Variables to hold the start and end vertices of edges
@@ -36,9 +70,81 @@ void read_problem(string file_path) {
         while (tmp_line >> end_ver) {
             tmp_line >> g_arcs[start_ver][end_ver];
             g_neighbor[start_ver].emplace_back(end_ver);
+
+            // Fill the weight planes with the edges to the right and below neighbors,
+            // the planes keep INF at the borders of the graph
+            if (end_ver == start_ver + 1 && end_ver % g_dim) g_row_w[start_ver] = g_arcs[start_ver][end_ver];
+            else if (end_ver == start_ver + g_dim && end_ver < g_n_vtx) g_col_w[start_ver] = g_arcs[start_ver][end_ver];
         }
     }
     ifile.close(); // Close the input file
+
+    build_masks(get_planes(), g_cell_mask, g_row_mask);
+}
+
+/**
+ * @brief Reads the weight planes of a graph from a problem file,
+ * without the distance matrix and the adjacency list, and builds its masks.
+ * The file may come from a client of the server, so it is checked: a header other than a single
+ * positive dimension, a vertex out of the graph or a length out of [0, INF) rejects it.
+ *
+ * @param file_path The path to the problem file.
+ * @param dim The dimension of the graph.
+ * @param row_w The weight plane of the horizontal edges, allocated with alloc_array.
+ * @param col_w The weight plane of the vertical edges, allocated with alloc_array.
+ * @param cell_mask The bitset of the open vertices, allocated with alloc_array.
+ * @param row_mask The bitset of the horizontal edges, allocated with alloc_array.
+ * @return true if the file was read, false if it cannot be opened or is not a valid grid,
+ * in which case nothing is allocated.
+ */
+bool read_grid(string file_path, int &dim, int* &row_w, int* &col_w,
+               uint64_t* &cell_mask, uint64_t* &row_mask) {
+    row_w = col_w = NULL;
+    cell_mask = row_mask = NULL;
+    ifstream ifile(file_path.c_str()); // Open the specified file
+    if (ifile.fail()) return false;
+
+    // Read the dimension of the graph from the first line, which holds nothing else (a 3D mesh has three)
+    string line = "", extra = "";
+    getline(ifile, line);
+    stringstream head_line(line);
+    if (!(head_line >> dim) || head_line >> extra || dim <= 0 || dim > 46340) return false; // dim * dim fits in an int
+
+    int n_vtx = dim * dim;
+    row_w = alloc_array<int>(n_vtx);
+    col_w = alloc_array<int>(n_vtx);
+    fill(row_w, row_w + n_vtx, INF); // The edges omitted by the file are missing
+    fill(col_w, col_w + n_vtx, INF);
+
+    int start_ver = -1, end_ver = -1, length = 0; // Variables to hold the edges
+    bool is_valid = true;
+
+    // Read each line until the end of the file
+    while (is_valid && getline(ifile, line)) {
+        stringstream tmp_line(line);
+        if (!(tmp_line >> start_ver)) continue; // Empty line
+        if (start_ver < 0 || start_ver >= n_vtx) is_valid = false;
+
+        // Keep the edges to the right and below neighbors
+        while (is_valid && tmp_line >> end_ver >> length) {
+            if (end_ver < 0 || end_ver >= n_vtx || length < 0 || length >= INF) is_valid = false;
+            else if (end_ver == start_ver + 1 && end_ver % dim) row_w[start_ver] = length;
+            else if (end_ver == start_ver + dim) col_w[start_ver] = length;
+        }
+    }
+    ifile.close(); // Close the input file
+    if (!is_valid) {
+        free_memory(row_w);
+        free_memory(col_w);
+        row_w = col_w = NULL;
+        return false;
+    }
+
+    cell_mask = alloc_array<uint64_t>(mask_words(n_vtx));
+    row_mask = alloc_array<uint64_t>(mask_words(n_vtx));
+    t_planes G = {dim, n_vtx, n_vtx, row_w, col_w, NULL, NULL, NULL};
+    build_masks(G, cell_mask, row_mask);
+    return true;
 }
 
 #endif // !_Read_Problem_h
@@ -50,6 +50,7 @@ void save_shortest_pre(string output_path) {
     // Iterate through each vertex to write its predecessor information
     for (int i = 0; i < g_n_vtx; i++) {
         if (i == g_src_vtx) continue; // Skip the source vertex
+        if (g_shortest_dis[i] >= INF) continue; // Skip the vertices that cannot be reached, without a predecessor
 
         // Write vertex coordinates and its predecessor's coordinates
         ofile << i / g_dim << " " << i % g_dim << " \t "
@@ -60,3 +61,33 @@ void save_shortest_pre(string output_path) {
 
     cout << "Save the predecessor: " << output_path << endl;
 }
+
+/**
+ * @brief Saves the shortest distance results on a 3D mesh to a specified output file.
+ *
+ * @param output_path The path to the output file where shortest distances will be saved.
+ * @param dim_x The number of columns of a plane.
+ * @param dim_y The number of rows of a plane.
+ * @param dim_z The number of planes.
+ * @param src The source vertex.
+ * @param D The shortest distances from the source vertex.
+ */
+void save_mesh_dis(string output_path, int dim_x, int dim_y, int dim_z, int src, const int* D) {
+    ofstream ofile(output_path.c_str());	// Open the output file for writing
+    int plane_size = dim_x * dim_y, n_vtx = plane_size * dim_z;
+
+    // Write the number of vertices to the file
+    ofile << n_vtx << " " << endl;
+    // Write the source vertex coordinates (plane, row and column)
+    ofile << src / plane_size << " " << src % plane_size / dim_x << " " << src % dim_x << endl << endl;
+
+    // Iterate through each vertex to write its shortest distance, INF if it cannot be reached
+    for (int i = 0; i < n_vtx; i++) {
+        ofile << i / plane_size << " " << i % plane_size / dim_x << " " << i % dim_x << " \t "
+              << min(D[i], INF) << " " << endl;
+    }
+
+    ofile.close(); // Close the output file
+
+    cout << "Save the shortest distance: " << output_path << endl;
+}
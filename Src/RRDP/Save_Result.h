@@ -18,4 +18,16 @@ void save_shortest_dis(string output_path);
  */
 void save_shortest_pre(string output_path);
 
+/**
+ * @brief Saves the shortest distance results on a 3D mesh to a specified output file.
+ *
+ * @param output_path The path to the output file where shortest distances will be saved.
+ * @param dim_x The number of columns of a plane.
+ * @param dim_y The number of rows of a plane.
+ * @param dim_z The number of planes.
+ * @param src The source vertex.
+ * @param D The shortest distances from the source vertex.
+ */
+void save_mesh_dis(string output_path, int dim_x, int dim_y, int dim_z, int src, const int* D);
+
 #endif // !_Save_Result_h
@@ -0,0 +1,169 @@
+#ifndef _Verify_Certificate_h
+#define _Verify_Certificate_h
+
+#include <thread>
+
+#include "Global_Var.h"
+
+// Result of the certificate check of a block of rows
+struct t_certificate_block {
+    int n_violations;   // Number of violated conditions
+    int first_row;      // First row violating a condition, -1 if none
+    int n_ties;         // Number of vertices whose predecessor has the same distance (zero-length edge)
+};
+
+/**
+ * @brief Checks the certificate conditions of the rows [row_begin, row_end),
+ * the rows of all the planes being numbered one after the other.
+ * The edge conditions are written without branches, so that they are vectorized.
+ *
+ * @param G The weight planes of the graph.
+ * @param src The source vertex.
+ * @param D The shortest distances to be checked.
+ * @param P The predecessors to be checked.
+ * @param row_begin The first row of the block.
+ * @param row_end The row after the last row of the block.
+ * @param result The result of the block.
+ */
+void verify_rows(const t_planes &G, int src, const int* D, const int* P,
+                 int row_begin, int row_end, t_certificate_block &result) {
+    int dim = G.dim, n_vtx = G.n_vtx, plane_size = G.plane_size;
+    int n_rows = n_vtx / dim, plane_rows = plane_size / dim; // Rows of the graph and of a plane
+    const int* row_w = G.row_w;
+    const int* col_w = G.col_w;
+    const int* z_w = G.z_w;
+    result.n_violations = 0;
+    result.first_row = -1;
+    result.n_ties = 0;
+
+    for (int row = row_begin; row < row_end; row++) {
+        const int* D_row = D + (size_t)row * dim;
+        const int* w_row = row_w + (size_t)row * dim;
+        const int* w_col = col_w + (size_t)row * dim;
+        bool has_below = row % plane_rows + 1 < plane_rows;       // The next row is in the same plane
+        bool has_next_plane = z_w && row + plane_rows < n_rows;  // The same row of the next plane exists
+        int n_bad = 0;
+
+        // No horizontal edge (v, v + 1) can shorten a distance in either direction
+        for (int col = 0; col + 1 < dim; col++)
+            n_bad += (D_row[col] + w_row[col] < D_row[col + 1]) | (D_row[col + 1] + w_row[col] < D_row[col]);
+        // No vertical edge (v, v + dim) can shorten a distance in either direction
+        if (has_below) {
+            for (int col = 0; col < dim; col++)
+                n_bad += (D_row[col] + w_col[col] < D_row[col + dim]) | (D_row[col + dim] + w_col[col] < D_row[col]);
+        }
+        // No edge (v, v + plane_size) to the next plane can shorten a distance in either direction
+        if (has_next_plane) {
+            const int* w_z = z_w + (size_t)row * dim;
+            for (int col = 0; col < dim; col++)
+                n_bad += (D_row[col] + w_z[col] < D_row[col + plane_size])
+                       | (D_row[col + plane_size] + w_z[col] < D_row[col]);
+        }
+
+        // Every predecessor is a neighbor lying on a shortest path
+        for (int col = 0; col < dim; col++) {
+            int vtx = row * dim + col, pre = P[vtx], diff = pre - vtx;
+            if (vtx == src) {
+                n_bad += (D[vtx] != 0) | (pre != vtx);
+                continue;
+            }
+            if (D[vtx] >= INF) continue; // Not reached, so without a predecessor; the edge conditions prove it
+
+            const int* lengths = NULL; // The weight plane of the edge between the vertex and its predecessor
+            if ((diff == -1 && col > 0) || (diff == 1 && col + 1 < dim)) lengths = row_w;
+            else if ((diff == -dim && row % plane_rows > 0) || (diff == dim && has_below)) lengths = col_w;
+            else if (z_w && ((diff == -plane_size && row >= plane_rows) || (diff == plane_size && has_next_plane)))
+                lengths = z_w;
+            if (!lengths) {
+                n_bad++;
+                continue;
+            }
+            n_bad += D[pre] + lengths[min(vtx, pre)] != D[vtx];
+            result.n_ties += D[pre] == D[vtx];
+        }
+
+        if (n_bad > 0 && result.first_row < 0) result.first_row = row;
+        result.n_violations += n_bad;
+    }
+}
+
+/**
+ * @brief Checks that the predecessors form a tree rooted at the source vertex,
+ * by following each predecessor chain once.
+ *
+ * @param n_vtx The total number of vertices in the graph.
+ * @param src The source vertex.
+ * @param D The shortest distances, the vertices at distance INF are not in the tree.
+ * @param P The predecessors to be checked, all of them must be vertices of the graph.
+ * @return true if every predecessor chain reaches the source vertex.
+ */
+bool verify_tree(int n_vtx, int src, const int* D, const int* P) {
+    // 0: not visited, 1: on the current chain, 2: reaches the source vertex
+    vector<char> state(n_vtx, 0);
+    vector<int> chain;
+    state[src] = 2;
+
+    for (int vtx = 0; vtx < n_vtx; vtx++) {
+        if (D[vtx] >= INF) continue;
+        int cur_vtx = vtx;
+        while (state[cur_vtx] == 0) {
+            state[cur_vtx] = 1;
+            chain.emplace_back(cur_vtx);
+            cur_vtx = P[cur_vtx];
+        }
+        if (state[cur_vtx] == 1) return false; // The chain runs into itself
+        for (int chain_vtx : chain) state[chain_vtx] = 2;
+        chain.clear();
+    }
+    return true;
+}
+
+/**
+ * @brief Verifies the shortest path certificate of a graph and a source vertex
+ * in one parallel pass, without solving the problem again:
+ * D[src] == 0, no edge (u, v) satisfies D[u] + w < D[v], every P[v] of a reached vertex is a neighbor
+ * of v with D[P[v]] + w == D[v], and P forms a tree rooted at the source vertex.
+ * A missing edge has the length INF in the weight planes, so it never satisfies any condition.
+ *
+ * @param G The weight planes of the graph, 2D or 3D.
+ * @param src The source vertex.
+ * @param D The shortest distances to be checked.
+ * @param P The predecessors to be checked.
+ * @param n_threads The number of threads.
+ * @return true if the certificate holds, i.e. D and P are shortest distances and a shortest path tree.
+ */
+bool verify_certificate(const t_planes &G, int src, const int* D, const int* P, int n_threads) {
+    int n_rows = G.n_vtx / G.dim;
+
+    n_threads = max(1, min(n_threads, n_rows));
+    vector<t_certificate_block> results(n_threads);
+    vector<thread> threads;
+    for (int i = 0; i < n_threads; i++) {
+        int row_begin = (int)((long long)n_rows * i / n_threads);
+        int row_end = (int)((long long)n_rows * (i + 1) / n_threads);
+        threads.emplace_back(verify_rows, cref(G), src, D, P, row_begin, row_end, ref(results[i]));
+    }
+    for (thread& t : threads) t.join();
+
+    int n_violations = 0, n_ties = 0, first_row = -1;
+    for (const t_certificate_block& result : results) {
+        n_violations += result.n_violations;
+        n_ties += result.n_ties;
+        if (first_row < 0) first_row = result.first_row;
+    }
+    if (n_violations > 0) {
+        cout << "The certificate is violated " << n_violations << " times, first in row "
+             << first_row << endl;
+        return false;
+    }
+
+    // With positive edge lengths, the distances strictly decrease along the predecessors,
+    // so P is a tree. Zero-length edges may close a cycle, which is checked explicitly.
+    if (n_ties > 0 && !verify_tree(G.n_vtx, src, D, P)) {
+        cout << "The predecessors do not form a tree" << endl;
+        return false;
+    }
+    return true;
+}
+
+#endif // !_Verify_Certificate_h
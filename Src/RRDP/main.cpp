@@ -1,4 +1,5 @@
 #include <ctime>
+#include <chrono>
 #include <cstring>
 #include <iomanip>
 #include <sstream>
@@ -8,6 +9,12 @@
 #include "Save_Result.h"
 #include "Heap_Dijkstra.h"
 #include "RRDP.h"
+#include "Distance_Oracle.h"
+#include "Bounded_RRDP.h"
+#include "Memory_Alloc.h"
+#include "Perf_Counter.h"
+#include "Verify_Certificate.h"
+#include "RRDP_3D.h"
 
 // Global variables to store total computation times
 double total_time1 = 0; // Time taken by Dijkstra's algorithm
@@ -25,47 +32,22 @@ double get_time(clock_t start_time, clock_t end_time) {
 	return (double)(end_time - start_time) / CLOCKS_PER_SEC; // Convert clock ticks to seconds
 }
 
-/**
- * @brief Compares the results of two shortest path calculations.
- * 
- * @return true if the results match, false if they differ.
- */
-bool compare() {
-	ifstream ifile1("dijkstra_dis.txt"); // Open the Dijkstra's result file
-	ifstream ifile2("rrdp_dis.txt"); // Open the our (RRDP's) result file
-
-	string tmp1, tmp2; // Temporary strings for reading lines
-	while (getline(ifile1, tmp1) && getline(ifile2, tmp2)) {
-		if (tmp1 == tmp2) continue; // Skip if the results match
-
-		// Print mismatched results
-		cout << "right: " << tmp1 << endl;
-		cout << "wrong: " << tmp2 << endl;
-		ifile1.close(); // Close both files
-		ifile2.close();
-		return false; // Return false if there is a discrepancy
-	}
-
-	ifile1.close(); // Close both files
-	ifile2.close(); 
-	return true; // Return true if all results match
-}
-
 /**
  * @brief Records the execution times of the algorithms.
  */
 void record_time() {
 	ofstream ofile;
 	
-	// Record the time taken by Dijkstra's algorithm
-	ofile.open("dijkstra_time.txt", ios::app);
-	ofile << total_time1 << endl;
-	ofile.close();
-	
 	// Record the time taken by RRDP algorithm
 	ofile.open("rrdp_time.txt", ios::app);
 	ofile << total_time2 << endl;
 	ofile.close();
+	if (!g_run_dijkstra) return;
+
+	// Record the time taken by Dijkstra's algorithm
+	ofile.open("dijkstra_time.txt", ios::app);
+	ofile << total_time1 << endl;
+	ofile.close();
 	
 	// Record the ratio of the two times
 	ofile.open("ratio_time.txt", ios::app);
@@ -73,6 +55,196 @@ void record_time() {
 	ofile.close();
 }
 
+/**
+ * @brief Prepares the distance oracle, answers the queries from the source vertex
+ * to all vertices with it and compares the results with those of RRDP.
+ */
+void test_oracle() {
+	t_oracle oracle;
+	cout << endl;
+
+	// Map the oracle file if it exists and belongs to this graph, otherwise build the oracle and save it
+	start_time = clock();
+	bool is_loaded = load_oracle(ORACLE_PATH, oracle);
+	if (is_loaded && !oracle_matches_graph(oracle, g_oracle_stride)) {
+		cout << "The oracle file " << ORACLE_PATH << " belongs to another graph or stride, rebuild it" << endl;
+		destroy_oracle(oracle);
+		is_loaded = false;
+	}
+	if (!is_loaded) {
+		build_oracle(g_oracle_stride, oracle);
+		if (ORACLE_PATH.length()) save_oracle(ORACLE_PATH, oracle);
+	}
+	end_time = clock();
+	cout << "Distance oracle with stride " << oracle.stride << " prepared in "
+		 << get_time(start_time, end_time) << " seconds" << endl;
+
+	// Answer the queries from the source vertex to every vertex
+	bool is_same = true;
+	start_time = clock();
+	for (int vtx = 0; vtx < g_n_vtx; vtx++) {
+		if (oracle_query(oracle, g_src_vtx, vtx) != g_shortest_dis[vtx]) is_same = false;
+	}
+	end_time = clock();
+	cout << "Distance oracle answered " << g_n_vtx << " queries in "
+		 << get_time(start_time, end_time) << " seconds ("
+		 << get_time(start_time, end_time) / g_n_vtx * 1e6 << " us per query, RRDP needs "
+		 << total_time2 / g_repeat_time * 1e6 << " us per source)" << endl;
+	cout << "Distance oracle results are " << (is_same ? "the SAME as" : "DIFFERENT from") << " RRDP" << endl;
+
+	destroy_oracle(oracle);
+}
+
+/**
+ * @brief Runs the bounded RRDP with the radius and compares the vertices it finds
+ * with the vertices within the radius according to RRDP.
+ */
+void test_bounded() {
+	int* D = alloc_array<int>(g_n_vtx);
+	int* P = alloc_array<int>(g_n_vtx);
+	vector<t_iso_vertex> iso;
+	t_bounded_state S; // Workspace reused by the repetitions
+	cout << endl;
+
+	start_time = clock(); // Start timing for bounded RRDP algorithm
+	for (int i_repeat = 0; i_repeat < g_repeat_time; i_repeat++) {
+		rrdp_bounded(g_radius, D, P, iso, S); // Execute bounded RRDP algorithm
+	}
+	end_time = clock(); // End timing for bounded RRDP algorithm
+	double total_time3 = get_time(start_time, end_time);
+	cout << "Bounded RRDP with radius " << g_radius << " found " << iso.size() << " vertices" << endl
+		 << "Repeat Time : " << g_repeat_time << endl
+		 << "the total time is: " << total_time3 << " seconds ("
+		 << total_time2 / total_time3 << " times faster than RRDP)" << endl;
+
+	// Every vertex within the radius must be found with its shortest distance
+	size_t n_within = 0;
+	bool is_same = true;
+	for (int vtx = 0; vtx < g_n_vtx; vtx++) {
+		if (g_shortest_dis[vtx] <= g_radius) n_within++;
+	}
+	for (const t_iso_vertex& iso_vtx : iso) {
+		if (g_shortest_dis[iso_vtx.vtx] != iso_vtx.dis) is_same = false;
+	}
+	if (n_within != iso.size()) is_same = false;
+	cout << "Bounded RRDP results are " << (is_same ? "the SAME as" : "DIFFERENT from") << " RRDP" << endl;
+
+	free_memory(D);
+	free_memory(P);
+}
+
+/**
+ * @brief Prints the memory configuration and its effects on the RRDP sweeps.
+ *
+ * @param tlb_misses The data TLB load misses of all the repetitions, -1 if unknown.
+ */
+void report_memory(long long tlb_misses) {
+	// Each sweep reads both weight planes and writes D and P once
+	double bytes = (double)g_n_vtx * 4 * sizeof(int) * g_repeat_time;
+	const char* page_names[] = {"default", "transparent huge", "explicit huge"};
+	const char* numa_names[] = {"first-touch", "interleave"};
+
+	// Report the page size and placement the arrays actually got, and what was asked if it differs
+	int page_mode = used_page_mode(), numa_mode = used_numa_mode();
+	cout << "Pages: " << page_names[page_mode];
+	if (page_mode != g_page_mode) cout << " (" << page_names[g_page_mode] << " unavailable)";
+	cout << ", NUMA placement: " << numa_names[numa_mode];
+	if (numa_mode != g_numa_mode) cout << " (" << numa_names[g_numa_mode] << " unavailable)";
+	cout << endl
+		 << "Effective bandwidth: " << bytes / total_time2 / 1e9 << " GB/s" << endl;
+	if (tlb_misses >= 0)
+		cout << "dTLB load misses: " << tlb_misses << " (" << (double)tlb_misses / g_repeat_time << " per run)" << endl;
+	else
+		cout << "dTLB load misses: unavailable" << endl;
+}
+
+/**
+ * @brief Solves the SSSP problem on a 3D mesh with the plane-by-plane RRDP, verifies its results
+ * with the shortest path certificate, and compares its time and results with Dijkstra's algorithm on the mesh.
+ */
+void test_mesh() {
+	t_mesh mesh;
+	if (!read_mesh(PROBLEM_PATH, mesh)) {
+		cout << __FUNCTION__ << endl
+			 << "Fail to open the file "
+			 << PROBLEM_PATH << endl;
+		exit(EXIT_FAILURE);
+	}
+	cout << "\nFinished reading the 3D mesh " << mesh.dim_x << " x " << mesh.dim_y << " x " << mesh.dim_z
+		 << " -- " << endl << PROBLEM_PATH << endl << endl;
+	if (g_src_vtx_col < 0 || g_src_vtx_col >= mesh.dim_x || g_src_vtx_row < 0 || g_src_vtx_row >= mesh.dim_y
+		|| g_src_vtx_plane < 0 || g_src_vtx_plane >= mesh.dim_z) {
+		cout << "ERROR\nThe source vertex is out of the mesh!!!\n\n" << endl;
+		exit(EXIT_FAILURE);
+	}
+	int src = (g_src_vtx_plane * mesh.dim_y + g_src_vtx_row) * mesh.dim_x + g_src_vtx_col;
+
+	int* dijkstra_dis = alloc_array<int>(mesh.n_vtx);
+	int* rrdp_dis = alloc_array<int>(mesh.n_vtx);
+	int* P = alloc_array<int>(mesh.n_vtx);
+	fill(rrdp_dis, rrdp_dis + mesh.n_vtx, INF); // RRDP never writes the blocked vertices
+
+	if (g_run_dijkstra) {
+		start_time = clock(); // Start timing for Dijkstra's algorithm
+		for (int i_repeat = 0; i_repeat < g_repeat_time; i_repeat++) {
+			dijkstra_heap(get_mesh_planes(mesh), src, dijkstra_dis, P); // Execute Dijkstra's algorithm
+		}
+		end_time = clock(); // End timing for Dijkstra's algorithm
+		total_time1 = get_time(start_time, end_time); // Calculate total time taken
+		cout << "Dijkstra with binary heap calculate source vertex : ("
+			 << g_src_vtx_plane << ", " << g_src_vtx_row << ", " << g_src_vtx_col << ")" << endl
+			 << "Repeat Time : " << g_repeat_time << endl
+			 << "the total time is: " << total_time1 << " seconds" << endl;
+		save_mesh_dis("dijkstra_dis.txt", mesh.dim_x, mesh.dim_y, mesh.dim_z, src, dijkstra_dis);
+		cout << endl;
+	}
+
+	start_time = clock(); // Start timing for RRDP algorithm
+	for (int i_repeat = 0; i_repeat < g_repeat_time; i_repeat++) {
+		rrdp_mesh(mesh, src, rrdp_dis, P); // Execute RRDP algorithm
+	}
+	end_time = clock(); // End timing for RRDP algorithm
+	total_time2 = get_time(start_time, end_time); // Calculate total time taken
+	cout << "New method calculate source vertex : ("
+		 << g_src_vtx_plane << ", " << g_src_vtx_row << ", " << g_src_vtx_col << ")" << endl
+		 << "Repeat Time : " << g_repeat_time << endl
+		 << "the total time is: " << total_time2 << " seconds" << endl;
+	save_mesh_dis("rrdp_dis.txt", mesh.dim_x, mesh.dim_y, mesh.dim_z, src, rrdp_dis);
+	cout << endl;
+
+	record_time(); // Print and record execution times
+	// The verification runs on several threads, so it is timed by the wall clock instead of clock()
+	chrono::steady_clock::time_point verify_start = chrono::steady_clock::now();
+	bool is_certified = verify_certificate(get_mesh_planes(mesh), src, rrdp_dis, P, thread::hardware_concurrency());
+	double verify_time = chrono::duration<double>(chrono::steady_clock::now() - verify_start).count();
+	if (is_certified) { // Check the shortest path certificate of RRDP's results
+		cout << setw(30) << setfill('*') << "CERTIFIED!"; // Print if the results are shortest paths
+		cout << setw(20) << setfill('*') << "" << endl;
+	} else {
+		cout << setw(30) << setfill('*') << "NOT CERTIFIED!"; // Print if the results are wrong
+		cout << setw(16) << setfill('*') << "" << endl;
+	}
+	if (g_run_dijkstra) { // Compare the distances of both algorithms
+		bool is_same = equal(rrdp_dis, rrdp_dis + mesh.n_vtx, dijkstra_dis);
+		if (is_same) {
+			cout << setw(30) << setfill('*') << "SAME!"; // Print if the results are the same
+			cout << setw(25) << setfill('*') << "" << endl;
+		} else {
+			cout << setw(30) << setfill('*') << "DIFFERENT!"; // Print if the results differ
+			cout << setw(20) << setfill('*') << "" << endl;
+		}
+	}
+
+	cout << "Verification time: " << verify_time << endl;
+	if (g_run_dijkstra) cout << "Dijkstra time:  " << total_time1 << endl;
+	cout << "Our method time: " << total_time2 << endl;
+	if (g_run_dijkstra) cout << "Time improvement rate: " << total_time1 / total_time2 << endl;
+
+	free_memory(dijkstra_dis);
+	free_memory(rrdp_dis);
+	free_memory(P);
+	destroy_mesh(mesh);
+}
 
 int main(int argc, char* argv[]) {
 	if (argc < 2) { // Check if config path argument is provided
@@ -82,6 +254,10 @@ int main(int argc, char* argv[]) {
 	
     string config_file_path = argv[1]; // Get the configuration file path from command line
     get_parameter(config_file_path); // Load parameters from the config file
+	if (g_dim_z > 1) { // A 3D mesh has its own weight planes, without the 2D distance matrix
+		test_mesh();
+		return 1;
+	}
 	allocate_memory();	// Allocate memory for global variables
  
     read_problem(PROBLEM_PATH);	// Read problem data
@@ -89,49 +265,64 @@ int main(int argc, char* argv[]) {
 		 << PROBLEM_PATH << endl << endl;
 
  	// *******************************************DIJKSTRA************************************************
- 	start_time = clock(); // Start timing for Dijkstra's algorithm
-	for (int i_repeat = 0; i_repeat < g_repeat_time; i_repeat++) {
-		dijkstra_heap(g_shortest_dis, g_parent); // Execute Dijkstra's algorithm
+	if (g_run_dijkstra) { // Only needed as a time baseline, RRDP is verified by its certificate
+		start_time = clock(); // Start timing for Dijkstra's algorithm
+		for (int i_repeat = 0; i_repeat < g_repeat_time; i_repeat++) {
+			dijkstra_heap(g_shortest_dis, g_parent); // Execute Dijkstra's algorithm
+		}
+		end_time = clock(); // End timing for Dijkstra's algorithm
+		total_time1 = get_time(start_time, end_time); // Calculate total time taken
+		cout << "Dijkstra with binary heap calculate source vertex : (" 
+			 << g_src_vtx_row << ", " << g_src_vtx_col << ")" << endl
+			 << "Repeat Time : " << g_repeat_time <<  endl 
+			 << "the total time is: " << total_time1 << " seconds" << endl;
+		save_shortest_dis("dijkstra_dis.txt");
+		save_shortest_pre("dijkstra_pre.txt");
+		cout << endl;
 	}
-	end_time = clock(); // End timing for Dijkstra's algorithm
-	total_time1 = get_time(start_time, end_time); // Calculate total time taken
-	cout << "Dijkstra with binary heap calculate source vertex : (" 
-		 << g_src_vtx_row << ", " << g_src_vtx_col << ")" << endl
-		 << "Repeat Time : " << g_repeat_time <<  endl 
-		 << "the total time is: " << total_time1 << " seconds" << endl;
-	save_shortest_dis("dijkstra_dis.txt");
-	save_shortest_pre("dijkstra_pre.txt");
-	cout << endl;
 	// ***************************************************************************************************
 
 	// *******************************************Another Method************************************************
+	int tlb_counter = open_tlb_counter(); // Count the data TLB misses of the sweeps
+	start_counter(tlb_counter);
 	start_time = clock(); // Start timing for RRDP algorithm
 	for (int i_repeat = 0; i_repeat < g_repeat_time; i_repeat++) {
 		rrdp(g_shortest_dis, g_parent); // Execute RRDP algorithm
 	}
 	end_time = clock(); // End timing for RRDP algorithm
+	long long tlb_misses = stop_counter(tlb_counter);
 	total_time2 = get_time(start_time, end_time); // Calculate total time taken
 	cout << "New method calculate source vertex : (" 
 		 << g_src_vtx_row << ", " << g_src_vtx_col << ")" << endl
 		 << "Repeat Time : " << g_repeat_time <<  endl 
 		 << "the total time is: " << total_time2 << " seconds" << endl;
+	report_memory(tlb_misses);
+	if (tlb_counter >= 0) close(tlb_counter);
 	save_shortest_dis("rrdp_dis.txt");
 	save_shortest_pre("rrdp_pre.txt");
  	cout << endl;
  	// ***************************************************************************************************
 
 	record_time(); // Print and record execution times
-	if (compare()) { // Compare the results from both algorithms
-		cout << setw(30) << setfill('*') << "SAME!"; // Print if results are the same
-		cout << setw(25) << setfill('*') << "" << endl;
-	} else {
-		cout << setw(30) << setfill('*') << "DIFFERENT!"; // Print if results differ
+	// The verification runs on several threads, so it is timed by the wall clock instead of clock()
+	chrono::steady_clock::time_point verify_start = chrono::steady_clock::now();
+	bool is_certified = verify_certificate(get_planes(), g_src_vtx, g_shortest_dis, g_parent, thread::hardware_concurrency());
+	double verify_time = chrono::duration<double>(chrono::steady_clock::now() - verify_start).count();
+	if (is_certified) { // Check the shortest path certificate of RRDP's results
+		cout << setw(30) << setfill('*') << "CERTIFIED!"; // Print if the results are shortest paths
 		cout << setw(20) << setfill('*') << "" << endl;
+	} else {
+		cout << setw(30) << setfill('*') << "NOT CERTIFIED!"; // Print if the results are wrong
+		cout << setw(16) << setfill('*') << "" << endl;
     }
 
-	cout << "Dijkstra time:  " << total_time1 << endl;
+	cout << "Verification time: " << verify_time << endl;
+	if (g_run_dijkstra) cout << "Dijkstra time:  " << total_time1 << endl;
 	cout << "Our method time: " << total_time2 << endl;
-	cout << "Time improvement rate: " << total_time1 / total_time2 << endl;
+	if (g_run_dijkstra) cout << "Time improvement rate: " << total_time1 / total_time2 << endl;
+
+	if (g_oracle_stride > 0) test_oracle(); // Answer the queries with the distance oracle
+	if (g_radius >= 0) test_bounded(); // Search the vertices within the radius
 	
 	destroy_memory(); // Free allocated memory
 	return 1;
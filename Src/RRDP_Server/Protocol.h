@@ -0,0 +1,56 @@
+#ifndef _Protocol_h
+#define _Protocol_h
+
+// Binary protocol of the RRDP server over a Unix-domain stream socket.
+// All integers are in the native byte order of the machine.
+//
+// A client sends any number of requests on one connection:
+//     t_request_header, the path of the instance file (path_len bytes),
+//     then n_queries pairs of int (source vertex, target vertex).
+// For every request the server answers:
+//     t_response_header, then the result of each query in order (see t_request_type),
+//     then t_response_trailer.
+// If the status is not RESPONSE_OK, no query result follows the header.
+// A request with more than MAX_QUERIES queries is refused, and the server then closes the connection.
+// A vertex that cannot be reached from the source vertex has the distance INF (0x3f3f3f3f),
+// an undefined predecessor, and an empty path.
+
+#define REQUEST_MAGIC 0x50445252 // "RRDP"
+#define MAX_QUERIES 65536         // Largest number of queries in one request
+
+// Type of the queries of one request
+enum t_request_type {
+    REQUEST_SINGLE_SOURCE = 1,  // Result: n_vtx distances, then n_vtx predecessors
+    REQUEST_POINT_TO_POINT = 2, // Result: distance, number of vertices on the path, then the path from source to target
+    REQUEST_DISTANCES = 3       // Result: n_vtx distances
+};
+
+// Status of a response
+enum t_response_status {
+    RESPONSE_OK = 0,
+    RESPONSE_BAD_REQUEST = 1,   // Unknown type, vertex out of the graph or too many queries
+    RESPONSE_NO_INSTANCE = 2    // The instance file cannot be opened or is not a valid grid
+};
+
+struct t_request_header {
+    int magic;      // Must be equal to REQUEST_MAGIC
+    int type;       // Type of the queries (t_request_type)
+    int path_len;   // Length of the path of the instance file
+    int n_queries;  // Number of queries
+};
+
+struct t_response_header {
+    int status;     // Status of the response (t_response_status)
+    int n_vtx;      // Number of vertices of the graph
+    int n_queries;  // Number of query results following the header
+    int cache_hit;  // 1 if the graph was already in the cache, 0 if it was read from the file
+};
+
+// Latency metrics of a request, in microseconds
+struct t_response_trailer {
+    long long load_us;  // Time to get the graph from the cache or from the file
+    long long solve_us; // Time spent by the workers on the queries, summed over the queries
+    long long total_us; // Time from receiving the request to sending the last result
+};
+
+#endif // !_Protocol_h
@@ -0,0 +1,477 @@
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <csignal>
+#include <chrono>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <functional>
+#include <unordered_map>
+#include <condition_variable>
+#include <unistd.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+
+#include "../RRDP/Global_Var.h"
+#include "../RRDP/Memory_Alloc.h"
+#include "../RRDP/Read_Problem.h"
+#include "../RRDP/RRDP.h"
+#include "Protocol.h"
+
+using namespace std;
+
+// Longest accepted path of an instance file
+#define MAX_PATH_LEN 4096
+
+string SOCKET_PATH = "/tmp/rrdp.sock"; // Path of the Unix-domain socket
+int g_n_workers = 4;        // Number of worker threads solving the queries
+int g_cache_size = 8;       // Maximum number of graphs kept in memory
+
+// Workspace of one RRDP run, reused by the following queries on the same graph.
+// With first-touch placement, the pages of a workspace are placed on the node of the worker that
+// allocated it, and those of a graph on the node of the connection thread that read it, but any worker
+// may sweep them later. On a machine with several NUMA nodes, -numa 1 interleaves them instead.
+struct t_workspace {
+    int* D;             // Shortest distances from the source vertex
+    int* P;             // Predecessor of each vertex in the shortest path tree
+};
+
+// A graph kept in the cache with the workspaces of the finished queries
+struct t_grid {
+    int dim;                        // Dimension of the graph
+    int n_vtx;                      // Total number of vertices in the graph
+    int* row_w;                     // Weight plane of the horizontal edges
+    int* col_w;                     // Weight plane of the vertical edges
+    uint64_t* cell_mask;            // Bitset of the open vertices
+    uint64_t* row_mask;             // Bitset of the horizontal edges
+    mutex ws_lock;                  // Protects free_ws
+    vector<t_workspace> free_ws;    // Workspaces not used by any query
+
+    ~t_grid() {
+        free_memory(row_w);
+        free_memory(col_w);
+        free_memory(cell_mask);
+        free_memory(row_mask);
+        for (t_workspace& ws : free_ws) {
+            free_memory(ws.D);
+            free_memory(ws.P);
+        }
+    }
+};
+
+// LRU cache of the graphs, the most recently used first.
+// A graph evicted while queries run on it is freed when the last of them finishes.
+list<pair<string, shared_ptr<t_grid>>> g_cache;
+unordered_map<string, list<pair<string, shared_ptr<t_grid>>>::iterator> g_cache_index;
+mutex g_cache_lock;
+
+// Tasks of one connection waiting for a worker thread
+struct t_task_queue {
+    queue<function<void()>> tasks;  // Tasks in the order of submission
+    bool is_ready = false;          // In g_ready_queues, i.e. it has tasks
+};
+
+// Connections having tasks waiting for a worker thread, served in turn,
+// so that a request with many queries does not delay the requests of the other connections
+queue<t_task_queue*> g_ready_queues;
+mutex g_task_lock;          // Protects g_ready_queues and the tasks of every connection
+condition_variable g_task_cv;
+
+mutex g_log_lock; // Serializes the log lines of the connections
+
+/**
+ * @brief Prints the usage instructions for the program.
+ */
+void print_help() {
+    cout << "Usage: ./RRDP_SERVER [Options]" << endl;
+    cout << "Options:" << endl;
+    cout << "\t-socket: Path of the Unix-domain socket (default: /tmp/rrdp.sock)" << endl;
+    cout << "\t-threads: Number of worker threads (default: 4)" << endl;
+    cout << "\t-cache: Maximum number of graphs kept in memory (default: 8)" << endl;
+    cout << "\t-numa: NUMA placement of the graphs and workspaces, 0 for first-touch, 1 to interleave (default: 0)" << endl;
+    cout << "\t-h: Display this help and exit" << endl;
+    exit(EXIT_FAILURE);
+}
+
+/**
+ * @brief Parses command line arguments to set the parameters for the program.
+ *
+ * @param argc The number of command line arguments.
+ * @param argv The array of command line arguments.
+ */
+void parse_arguments(int argc, char* argv[]) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-h") == 0) { // Check for help flag first
+            print_help();
+        }
+
+        if (i + 1 >= argc) {
+            cerr << "Error: " << argv[i] << " requires a value." << endl;
+            print_help();
+        }
+        if (strcmp(argv[i], "-socket") == 0) {
+            SOCKET_PATH = string(argv[++i]);
+        } else if (strcmp(argv[i], "-threads") == 0) {
+            g_n_workers = max(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "-cache") == 0) {
+            g_cache_size = max(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "-numa") == 0) {
+            g_numa_mode = atoi(argv[++i]);
+            if (g_numa_mode != NUMA_FIRST_TOUCH && g_numa_mode != NUMA_INTERLEAVE) {
+                cerr << "Error: -numa must be 0 or 1." << endl;
+                print_help();
+            }
+        } else {
+            cerr << "Error: Unknown argument '" << argv[i] << "'." << endl;
+            print_help();
+        }
+    }
+}
+
+/**
+ * @brief Gets the elapsed time since a time point in microseconds.
+ *
+ * @param start_time The time point.
+ * @return The elapsed time in microseconds.
+ */
+long long get_elapsed_us(chrono::steady_clock::time_point start_time) {
+    return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start_time).count();
+}
+
+/**
+ * @brief Gets a graph from the cache, reading it from the instance file on a miss.
+ *
+ * @param path The path to the instance file.
+ * @param cache_hit Set to true if the graph was in the cache.
+ * @return The graph, NULL if the instance file cannot be opened or is not a valid grid.
+ */
+shared_ptr<t_grid> get_grid(const string &path, bool &cache_hit) {
+    {
+        lock_guard<mutex> guard(g_cache_lock);
+        auto it = g_cache_index.find(path);
+        if (it != g_cache_index.end()) {
+            g_cache.splice(g_cache.begin(), g_cache, it->second); // Move to the front
+            cache_hit = true;
+            return g_cache.front().second;
+        }
+    }
+
+    // Read the graph without holding the lock, so that the other connections are not blocked
+    cache_hit = false;
+    shared_ptr<t_grid> grid(new t_grid());
+    if (!read_grid(path, grid->dim, grid->row_w, grid->col_w, grid->cell_mask, grid->row_mask))
+        return NULL; // Nothing is allocated, so the destructor frees NULL pointers
+    grid->n_vtx = grid->dim * grid->dim;
+
+    lock_guard<mutex> guard(g_cache_lock);
+    auto it = g_cache_index.find(path);
+    if (it != g_cache_index.end()) return it->second->second; // Read by another connection meanwhile
+
+    g_cache.emplace_front(path, grid);
+    g_cache_index[path] = g_cache.begin();
+    while ((int)g_cache.size() > g_cache_size) { // Evict the least recently used graph
+        g_cache_index.erase(g_cache.back().first);
+        g_cache.pop_back();
+    }
+    return grid;
+}
+
+/**
+ * @brief Takes a free workspace of a graph, or allocates a new one.
+ *
+ * @param grid The graph.
+ * @return The workspace.
+ */
+t_workspace acquire_workspace(t_grid &grid) {
+    {
+        lock_guard<mutex> guard(grid.ws_lock);
+        if (!grid.free_ws.empty()) {
+            t_workspace ws = grid.free_ws.back();
+            grid.free_ws.pop_back();
+            return ws;
+        }
+    }
+
+    t_workspace ws;
+    ws.D = alloc_array<int>(grid.n_vtx);
+    ws.P = alloc_array<int>(grid.n_vtx);
+    fill(ws.D, ws.D + grid.n_vtx, INF); // RRDP never writes the blocked vertices
+    return ws;
+}
+
+/**
+ * @brief Gives a workspace back to a graph.
+ *
+ * @param grid The graph.
+ * @param ws The workspace.
+ */
+void release_workspace(t_grid &grid, t_workspace ws) {
+    lock_guard<mutex> guard(grid.ws_lock);
+    grid.free_ws.emplace_back(ws);
+}
+
+/**
+ * @brief Solves one query with RRDP on the calling worker thread.
+ *
+ * @param grid The graph.
+ * @param type The type of the query (t_request_type).
+ * @param src The source vertex.
+ * @param dst The target vertex, only used by point-to-point queries.
+ * @param result The result of the query, in the format of the protocol.
+ */
+void solve_query(t_grid &grid, int type, int src, int dst, vector<int> &result) {
+    t_workspace ws = acquire_workspace(grid);
+
+    // Bind the graph, the source vertex and the workspace to the thread-local variables of RRDP
+    g_dim = grid.dim;
+    g_n_vtx = grid.n_vtx;
+    g_row_w = grid.row_w;
+    g_col_w = grid.col_w;
+    g_cell_mask = grid.cell_mask;
+    g_row_mask = grid.row_mask;
+    g_src_vtx = src;
+    g_src_vtx_row = src / grid.dim;
+    g_src_vtx_col = src % grid.dim;
+    rrdp(ws.D, ws.P);
+
+    if (type == REQUEST_POINT_TO_POINT) {
+        // Trace the path back from the target vertex
+        result.assign(2, 0);
+        result[0] = ws.D[dst];
+        if (ws.D[dst] < INF) { // If the target vertex cannot be reached, there is no path
+            for (int vtx = dst; ; vtx = ws.P[vtx]) {
+                result.emplace_back(vtx);
+                if (vtx == src) break;
+            }
+            result[1] = (int)result.size() - 2;
+            reverse(result.begin() + 2, result.end());
+        }
+    } else {
+        result.assign(ws.D, ws.D + grid.n_vtx);
+        if (type == REQUEST_SINGLE_SOURCE) result.insert(result.end(), ws.P, ws.P + grid.n_vtx);
+    }
+
+    ws.D[src] = INF; // A blocked source vertex is not swept by the next query
+    release_workspace(grid, ws);
+}
+
+/**
+ * @brief Runs the tasks of the connections, forever.
+ * Each turn takes one task of the next connection having tasks (round robin).
+ */
+void worker_loop() {
+    while (true) {
+        function<void()> task;
+        {
+            unique_lock<mutex> guard(g_task_lock);
+            g_task_cv.wait(guard, [] { return !g_ready_queues.empty(); });
+            t_task_queue* task_queue = g_ready_queues.front();
+            g_ready_queues.pop();
+            task = move(task_queue->tasks.front());
+            task_queue->tasks.pop();
+            // The connection waits for its tasks before destroying its queue, so it stays valid here
+            if (task_queue->tasks.empty()) task_queue->is_ready = false;
+            else g_ready_queues.push(task_queue); // Back to the end of the turn
+        }
+        task();
+    }
+}
+
+/**
+ * @brief Adds a task of a connection for the worker threads.
+ *
+ * @param task_queue The task queue of the connection.
+ * @param task The task.
+ */
+void submit_task(t_task_queue &task_queue, function<void()> task) {
+    {
+        lock_guard<mutex> guard(g_task_lock);
+        task_queue.tasks.push(move(task));
+        if (!task_queue.is_ready) {
+            task_queue.is_ready = true;
+            g_ready_queues.push(&task_queue);
+        }
+    }
+    g_task_cv.notify_one();
+}
+
+/**
+ * @brief Reads exactly n bytes from a socket.
+ *
+ * @return true if all the bytes were read, false on error or end of stream.
+ */
+bool read_full(int fd, void* buf, size_t n) {
+    char* ptr = (char*)buf;
+    while (n > 0) {
+        ssize_t len = read(fd, ptr, n);
+        if (len <= 0) return false;
+        ptr += len, n -= len;
+    }
+    return true;
+}
+
+/**
+ * @brief Writes exactly n bytes to a socket.
+ *
+ * @return true if all the bytes were written, false on error.
+ */
+bool write_full(int fd, const void* buf, size_t n) {
+    const char* ptr = (const char*)buf;
+    while (n > 0) {
+        ssize_t len = send(fd, ptr, n, MSG_NOSIGNAL);
+        if (len <= 0) return false;
+        ptr += len, n -= len;
+    }
+    return true;
+}
+
+/**
+ * @brief Answers the requests of one connection until the client closes it.
+ * The queries of a request are solved in parallel by the worker threads,
+ * and each result is sent as soon as it and the results before it are ready.
+ * At most 2 * g_n_workers queries of the connection are waiting or solved at a time,
+ * the next one being submitted when a result is sent, so the results of a client
+ * that does not read them do not pile up in memory.
+ *
+ * @param fd The socket of the connection.
+ */
+void handle_connection(int fd) {
+    t_task_queue task_queue; // Tasks of this connection waiting for a worker thread
+    t_request_header request;
+    while (read_full(fd, &request, sizeof(request))) {
+        chrono::steady_clock::time_point start_time = chrono::steady_clock::now();
+        if (request.magic != REQUEST_MAGIC || request.path_len <= 0 || request.path_len > MAX_PATH_LEN
+            || request.n_queries < 0) break; // Not a client of this protocol
+
+        string path(request.path_len, '\0');
+        if (!read_full(fd, &path[0], path.size())) break;
+        if (request.n_queries > MAX_QUERIES) { // Refuse it before allocating the queries, their bytes are not read
+            t_response_header response = {RESPONSE_BAD_REQUEST, 0, 0, 0};
+            t_response_trailer trailer = {0, 0, get_elapsed_us(start_time)};
+            if (write_full(fd, &response, sizeof(response))) write_full(fd, &trailer, sizeof(trailer));
+            break;
+        }
+        vector<int> queries(2 * (size_t)request.n_queries);
+        if (!read_full(fd, queries.data(), queries.size() * sizeof(int))) break;
+
+        t_response_header response = {RESPONSE_OK, 0, 0, 0};
+        t_response_trailer trailer = {0, 0, 0};
+        bool cache_hit = false;
+        shared_ptr<t_grid> grid = get_grid(path, cache_hit);
+        trailer.load_us = get_elapsed_us(start_time);
+
+        // Check the request before solving any query
+        if (grid == NULL) {
+            response.status = RESPONSE_NO_INSTANCE;
+        } else {
+            response.n_vtx = grid->n_vtx;
+            response.cache_hit = cache_hit;
+            if (request.type < REQUEST_SINGLE_SOURCE || request.type > REQUEST_DISTANCES)
+                response.status = RESPONSE_BAD_REQUEST;
+            for (int vtx : queries) {
+                if (vtx < 0 || vtx >= grid->n_vtx) response.status = RESPONSE_BAD_REQUEST;
+            }
+        }
+        if (response.status == RESPONSE_OK) response.n_queries = request.n_queries;
+        bool is_alive = write_full(fd, &response, sizeof(response));
+
+        if (response.status == RESPONSE_OK) {
+            int n_queries = request.n_queries, n_submitted = 0;
+            int max_in_flight = 2 * g_n_workers; // Queries waiting or solved at a time
+            vector<vector<int>> results(n_queries);
+            vector<long long> solve_us(n_queries, 0);
+            vector<bool> is_done(n_queries, false);
+            mutex done_lock;
+            condition_variable done_cv;
+
+            auto submit_next = [&] {
+                int i = n_submitted++;
+                submit_task(task_queue, [&, i] {
+                    chrono::steady_clock::time_point solve_start = chrono::steady_clock::now();
+                    solve_query(*grid, request.type, queries[2 * i], queries[2 * i + 1], results[i]);
+                    solve_us[i] = get_elapsed_us(solve_start);
+                    // Notify while holding the lock: once is_done[i] is seen, the connection thread
+                    // may leave this scope and destroy done_lock and done_cv
+                    lock_guard<mutex> guard(done_lock);
+                    is_done[i] = true;
+                    done_cv.notify_one();
+                });
+            };
+            while (n_submitted < min(n_queries, max_in_flight)) submit_next();
+
+            // Stream the results in order, the submitted tasks must all finish before leaving this scope
+            for (int i = 0; i < n_submitted; i++) {
+                {
+                    unique_lock<mutex> guard(done_lock);
+                    done_cv.wait(guard, [&] { return (bool)is_done[i]; });
+                }
+                if (is_alive) is_alive = write_full(fd, results[i].data(), results[i].size() * sizeof(int));
+                vector<int>().swap(results[i]); // Free the result once it is sent
+                trailer.solve_us += solve_us[i];
+                // One result is out, so one more query may be solved, unless the client is gone
+                if (is_alive && n_submitted < n_queries) submit_next();
+            }
+        }
+
+        trailer.total_us = get_elapsed_us(start_time);
+        if (is_alive) is_alive = write_full(fd, &trailer, sizeof(trailer));
+        {
+            lock_guard<mutex> guard(g_log_lock);
+            cout << path << " type " << request.type << " queries " << request.n_queries
+                 << " status " << response.status << (cache_hit ? " hit" : " miss")
+                 << " load " << trailer.load_us << " us solve " << trailer.solve_us
+                 << " us total " << trailer.total_us << " us" << endl;
+        }
+        if (!is_alive) break;
+    }
+    close(fd);
+}
+
+/**
+ * @brief This program keeps graphs in memory and answers shortest path requests
+ * on a Unix-domain socket, see Protocol.h for the format of the requests.
+ */
+int main(int argc, char* argv[]) {
+    parse_arguments(argc, argv);
+    signal(SIGPIPE, SIG_IGN); // A client closing its connection must not stop the server
+
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, SOCKET_PATH.c_str(), sizeof(addr.sun_path) - 1);
+    // Remove the socket of a previous run, but never another file or the socket of a running server
+    struct stat st;
+    if (lstat(SOCKET_PATH.c_str(), &st) == 0) {
+        int probe_fd = S_ISSOCK(st.st_mode) ? socket(AF_UNIX, SOCK_STREAM, 0) : -1;
+        bool is_in_use = probe_fd >= 0 && connect(probe_fd, (struct sockaddr*)&addr, sizeof(addr)) == 0;
+        if (probe_fd >= 0) close(probe_fd);
+        if (!S_ISSOCK(st.st_mode) || is_in_use) {
+            cout << __FUNCTION__ << endl
+                 << (is_in_use ? "Another server is listening on " : "Not a socket, refuse to replace ")
+                 << SOCKET_PATH << endl;
+            exit(EXIT_FAILURE);
+        }
+        unlink(SOCKET_PATH.c_str());
+    }
+    if (listen_fd < 0 || ::bind(listen_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(listen_fd, 64) < 0) {
+        cout << __FUNCTION__ << endl
+             << "Fail to listen on the socket "
+             << SOCKET_PATH << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < g_n_workers; i++)
+        thread(worker_loop).detach();
+    cout << "RRDP server listening on " << SOCKET_PATH << " with " << g_n_workers
+         << " workers and " << g_cache_size << " cached graphs" << endl;
+
+    while (true) {
+        int fd = accept(listen_fd, NULL, NULL);
+        if (fd < 0) continue;
+        thread(handle_connection, fd).detach(); // One thread per connection, the queries go to the workers
+    }
+}
@@ -12,6 +12,7 @@ def print_help():
     print("\t-mode: The mode of instance path (default: 0). 0 for general instances and 1 for special instances")
     print("\t-ConfigDir: Directory for config files (default: Config/[dim])")
     print("\t-InsDir: Base directory for instance files (default: ./General(or Special)_Instances/[dim])")
+    print("\t-dimz: The number of planes of a 3D mesh of dim x dim x dimz vertices (default: 1, a 2D mesh)")
     print("\t-h: Display this help and exit")
     sys.exit(0)
 
@@ -24,6 +25,7 @@ def parse_arguments():
     mode = 0  # Instance mode
     config_dir = f""  # Config directory
     ins_dir = f""  # Instance directory
+    dimz = 1  # Number of planes
 
     # Check for help flag
     if '-h' in sys.argv:
@@ -84,6 +86,16 @@ def parse_arguments():
             else:
                 print("Error: -InsDir requires a value.")  
                 sys.exit(1)
+        elif sys.argv[i] == '-dimz':
+            if i + 1 < len(sys.argv): 
+                try:
+                    dimz = int(sys.argv[i + 1])
+                except ValueError:
+                    print("Error: -dimz must be an integer.")  
+                    sys.exit(1)
+            else:
+                print("Error: -dimz requires a value.")  
+                sys.exit(1)
         else:
             print(f"Error: Unknown argument '{sys.argv[i]}'.")  # Unknown argument error
             print_help()  # Show help and exit
@@ -91,19 +103,22 @@ def parse_arguments():
         i += 2  # Move to next argument
 
 
+    # 3D meshes are kept apart from the 2D meshes of the same dimension
+    dim_name = f"{dim}x{dimz}" if dimz > 1 else f"{dim}"
+
     # Update config directory if not set
     if config_dir == '':
-        config_dir = f"Config/{dim}"
+        config_dir = f"Config/{dim_name}"
 
     # Update instance directory based on mode if not set
     if ins_dir == '':
         if mode == 0:
-            ins_dir = f"./General_Instances/{dim}"
+            ins_dir = f"./General_Instances/{dim_name}"
         else:
-            ins_dir = f"./Special_Instances/{dim}"
-    return dim, n_instances, repeat_time, mode, config_dir, ins_dir
+            ins_dir = f"./Special_Instances/{dim_name}"
+    return dim, n_instances, repeat_time, mode, config_dir, ins_dir, dimz
 
-def create_config_files(dim, n_instances, repeat_time, mode, config_dir, ins_dir):
+def create_config_files(dim, n_instances, repeat_time, mode, config_dir, ins_dir, dimz):
     """Create configuration files in the specified directory."""
     os.makedirs(config_dir, exist_ok=True)  # Create config directory if it doesn't exist
 
@@ -120,13 +135,16 @@ def create_config_files(dim, n_instances, repeat_time, mode, config_dir, ins_dir
             f.write(f"SOURCE_VERTEX_ROW:  {source_vertex_row}\n")
             f.write(f"SOURCE_VERTEX_COLUMN:  {source_vertex_column}\n")
             f.write(f"REPEAT_TIME: {repeat_time}\n")
+            if dimz > 1:  # Random plane for the source vertex of a 3D mesh
+                f.write(f"DIMENSION_Z:   {dimz}\n")
+                f.write(f"SOURCE_VERTEX_PLANE:  {random.randint(0, dimz - 1)}\n")
 
         print(f"Generated {file_path}")
 
 if __name__ == "__main__":
     random.seed()
-    dim, n_instances, repeat_time, mode, config_dir, ins_dir = parse_arguments()  # Parse arguments
-    create_config_files(dim, n_instances, repeat_time, mode, config_dir, ins_dir)  # Create config files
+    dim, n_instances, repeat_time, mode, config_dir, ins_dir, dimz = parse_arguments()  # Parse arguments
+    create_config_files(dim, n_instances, repeat_time, mode, config_dir, ins_dir, dimz)  # Create config files
     print("Config files generation completed.")
 
     file_path = "run.sh"